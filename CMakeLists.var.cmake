@@ -4,4 +4,6 @@ string(REGEX REPLACE "^(.*)_(.*)$" "\\1" effect_name "${PROJECT_NAME}")
 # List of components included in the project.
 set(components
     ${effect_name}_processor
+    ${effect_name}_offline
+    ${effect_name}_benchmark
 )
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "Benchmark.h"
+
+#include "GainProcessor.cuh"
+#include "LaunchTuning.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+struct Workload {
+    uint32_t channel_count;
+    uint32_t buffer_size;
+};
+
+constexpr std::array<uint32_t, 5> g_channel_counts {2u, 8u, 32u, 128u, 512u};
+constexpr std::array<uint32_t, 4> g_buffer_sizes {64u, 256u, 1024u, 4096u};
+constexpr uint32_t g_repetitions {5u};
+constexpr size_t g_min_samples_per_measurement {size_t {1} << 22};
+
+// Wall time of one emulated launch of the gain task over the workload with `block_size` threads per block
+double LaunchTime(const Workload& workload, uint32_t block_size) {
+    const size_t samples = static_cast<size_t>(workload.channel_count) * workload.buffer_size;
+    std::vector<float> input(samples, 0.5f);
+    std::vector<float> output(samples);
+    float* input_ports[] = {input.data()};
+    float* output_ports[] = {output.data()};
+
+    gain::ProcessorParameter params {};
+    params.channel_count = workload.channel_count;
+    params.buffer_capacity = workload.buffer_size;
+    params.buffer_length = workload.buffer_size;
+    params.gain = 0.5f;
+
+    // the launch of GainProcessor::OnBlueprintRebuild; `process` does not synchronize
+    gain::emulation::EmulatedDevice<GainProcessorDevice<float>> device {workload.buffer_size};
+    gain::emulation::LaunchConfig config {};
+    config.block_count = workload.channel_count;
+    config.thread_count = block_size;
+    config.sequential_threads = true;
+    // enough launches per measurement to stay well above the timer resolution
+    const uint32_t launches = std::max(1u, static_cast<uint32_t>(g_min_samples_per_measurement / samples));
+    return MeasureBest(g_repetitions, [&] {
+        for (uint32_t l = 0; l < launches; ++l) {
+            gain::emulation::Launch(config, [&](gain::emulation::HostContext& context) {
+                device->process(context, &params, nullptr, input_ports, output_ports);
+            });
+        }
+    }) / launches;
+}
+
+} // namespace
+
+int RunAutotuneBenchmark(const std::vector<std::string>& args) {
+    uint32_t max_block_size {gain::g_launch_tuning.max_block_size};
+    for (size_t i = 0; i + 1 < args.size(); i += 2) {
+        if (args[i] == "--max-block-size") {
+            max_block_size = static_cast<uint32_t>(std::strtoul(args[i + 1].c_str(), nullptr, 10));
+        }
+    }
+    const uint32_t wavefront_size = gain::g_launch_tuning.wavefront_size;
+    if (max_block_size < wavefront_size) {
+        std::cerr << "autotune: the maximum block size must be at least " << wavefront_size << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<uint32_t> block_sizes;
+    for (uint32_t block_size = wavefront_size; block_size <= max_block_size; block_size *= 2u) {
+        block_sizes.push_back(block_size);
+    }
+
+    // launch time of every workload and block size, relative to the best block size of the workload
+    std::cout << "launch time [us] of the emulated gain task per block size\n" << std::setw(18) << "channels x size";
+    for (uint32_t block_size : block_sizes) {
+        std::cout << std::setw(10) << block_size;
+    }
+    std::cout << "\n";
+    std::vector<double> relative_totals(block_sizes.size(), 0.0);
+    for (uint32_t channel_count : g_channel_counts) {
+        for (uint32_t buffer_size : g_buffer_sizes) {
+            std::vector<double> times;
+            for (uint32_t block_size : block_sizes) {
+                times.push_back(LaunchTime({channel_count, buffer_size}, block_size));
+            }
+            const double best = *std::min_element(times.begin(), times.end());
+            std::ostringstream workload;
+            workload << channel_count << " x " << buffer_size;
+            std::cout << std::setw(18) << workload.str() << std::fixed << std::setprecision(1);
+            for (size_t b = 0; b < block_sizes.size(); ++b) {
+                relative_totals[b] += times[b] / best;
+                std::cout << std::setw(10) << times[b] * 1e6;
+            }
+            std::cout << "\n";
+        }
+    }
+
+    // sums within the tolerance count as equal; then the smaller block wins
+    constexpr double tolerance {1.05};
+    size_t best_index = 0u;
+    for (size_t b = 1; b < block_sizes.size(); ++b) {
+        if (relative_totals[b] * tolerance < relative_totals[best_index]) {
+            best_index = b;
+        }
+    }
+    std::cout << "best block size of the emulation: " << block_sizes[best_index] << " (e.g., for gain_offline --threads-per-block)\n";
+    return EXIT_SUCCESS;
+}
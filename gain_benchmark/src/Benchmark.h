@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_BENCHMARK_H
+#define GAIN_BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Benchmarks of the gain processor. Each benchmark is a sub-command of gain_benchmark.
+
+// Times whole emulated launches of the gain task for each block size over a range of workloads and prints the
+// block size that is fastest in the host emulation. CPU times do not tell how the GPU schedules blocks, so the
+// result is for the emulation (gain_offline, the golden tests), not for the `g_launch_tunings` table
+// (see LaunchTuning.h)
+int RunAutotuneBenchmark(const std::vector<std::string>& args);
+
+// Loads the module library and measures the time until its supported platforms and processor entry names
+// are known, i.e., the share of the engine's session load spent in the module
+int RunStartupBenchmark(const std::vector<std::string>& args);
+
+// Runs the grids of the gain and the limiter task in the host emulation on 1 to N threads of a work-stealing pool
+// and prints the throughput and speedup for each thread count
+int RunScalingBenchmark(const std::vector<std::string>& args);
+
+// Times every device task in the host emulation relative to its scalar reference (GainReference.h) and prints the
+// ratios; with --max-ratio, fails if a task is slower than that. The timing counterpart of the golden tests, which
+// only check the results, as wall-clock ratios are too machine-dependent for a unit test
+int RunReferenceBenchmark(const std::vector<std::string>& args);
+
+// Best-of-`repetitions` wall time of `fn` in seconds
+template <class Fn>
+double MeasureBest(uint32_t repetitions, Fn&& fn) {
+    double best = std::numeric_limits<double>::max();
+    for (uint32_t r = 0; r < repetitions; ++r) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+#endif // GAIN_BENCHMARK_H
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "Benchmark.h"
+
+#include "GainProcessor.cuh"
+#include "GainReference.h"
+#include "GainTaskSettings.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+struct ReferenceOptions {
+    uint32_t channel_count {8u};
+    uint32_t buffer_size {1000u};
+    uint32_t repetitions {9u};
+    // 0: only print the ratios
+    double max_ratio {0.0};
+};
+
+struct ReferenceTask {
+    const char* name;
+    GainConfig::Specification specification;
+};
+
+// the tasks of the golden tests (see GainGoldenTests.cpp), each in the mode that selects it
+std::vector<ReferenceTask> Tasks() {
+    std::vector<ReferenceTask> tasks;
+    GainConfig::Specification specification {};
+    specification.gain_value = -0.37f;
+    tasks.push_back({"process", specification});
+    specification.sanitize = 1u;
+    tasks.push_back({"process_sanitized", specification});
+    specification.gain_value = 4.0f;
+    specification.limit = 1u;
+    specification.limiter_lookahead = 48u;
+    specification.limiter_release = 480u;
+    tasks.push_back({"process_limited", specification});
+    specification = {};
+    specification.gain_value = 0.5f;
+    specification.pair_mode = GainConfig::PairMode::eMidSide;
+    tasks.push_back({"process_pair", specification});
+    specification = {};
+    specification.gain_value = 4.0f;
+    specification.saturation = GainConfig::Saturation::eSoftClip;
+    specification.oversampling = 4u;
+    tasks.push_back({"process_saturated", specification});
+    return tasks;
+}
+
+// runs the scalar reference of the task of `settings` over all channels
+void RunReference(const GainTaskSettings& settings, const gain::ProcessorParameter& params, const std::vector<float>& input,
+    std::vector<float>& output, std::vector<uint32_t>& counters) {
+    switch (settings.GetTaskIndex()) {
+    case 1u:
+        gain_reference::Gain(params, input.data(), output.data(), counters.data());
+        break;
+    case 2u:
+        for (uint32_t c = 0; c < params.channel_count; ++c) {
+            gain_reference::LimiterState state;
+            const size_t offset = static_cast<size_t>(c) * params.buffer_capacity;
+            counters[c] = gain_reference::Limit(params, state, input.data() + offset, output.data() + offset);
+        }
+        break;
+    case 3u:
+        gain_reference::Pair(params, input.data(), output.data());
+        break;
+    case 4u:
+        for (uint32_t c = 0; c < params.channel_count; ++c) {
+            const size_t offset = static_cast<size_t>(c) * params.buffer_capacity;
+            gain_reference::Saturate(params, input.data() + offset, output.data() + offset, params.buffer_length);
+        }
+        break;
+    default:
+        gain_reference::Gain(params, input.data(), output.data());
+        break;
+    }
+}
+
+// Best time of one emulated launch of the task relative to the best time of its reference. Normalizing by the
+// reference keeps the ratio comparable between machines; alternating the runs exposes both to the same load.
+double TimeRatio(const ReferenceTask& task, const ReferenceOptions& options, double& task_time) {
+    const uint32_t channel_count = options.channel_count;
+    const uint32_t capacity = options.buffer_size;
+    const size_t samples = static_cast<size_t>(channel_count) * capacity;
+    GainTaskSettings settings {task.specification};
+    gain::ProcessorParameter params {};
+    settings.PrepareChunk(channel_count, capacity, capacity, true, params);
+
+    std::vector<float> input(samples);
+    for (size_t i = 0; i < samples; ++i) {
+        input[i] = 2.0f * std::sin(0.01f * static_cast<float>(i));
+    }
+    std::vector<float> output(samples);
+    std::vector<uint32_t> counters(channel_count);
+    std::vector<float> state(static_cast<size_t>(channel_count) * settings.GetStateSize());
+    float* input_ports[] = {input.data()};
+    float* output_ports[3] = {output.data(), reinterpret_cast<float*>(counters.data())};
+    output_ports[settings.GetStatePort()] = state.data();
+
+    // the launch geometry of GainProcessor::OnBlueprintRebuild
+    gain::emulation::EmulatedDevice<GainProcessorDevice<float>> device {capacity};
+    gain::emulation::LaunchConfig config {};
+    config.block_count = settings.GetBlockCount(channel_count);
+    config.thread_count = settings.GetThreadCount(channel_count, capacity);
+    config.shared_mem_size = settings.GetSharedMemorySize(config.thread_count);
+    config.sequential_threads = settings.GetTaskIndex() == 0u || settings.GetTaskIndex() == 3u;
+    const auto launch = [&] {
+        gain::emulation::Launch(config, [&](gain::emulation::HostContext& context) {
+            switch (settings.GetTaskIndex()) {
+            case 1u:
+                device->process_sanitized(context, &params, nullptr, input_ports, output_ports);
+                break;
+            case 2u:
+                device->process_limited(context, &params, nullptr, input_ports, output_ports);
+                break;
+            case 3u:
+                device->process_pair(context, &params, nullptr, input_ports, output_ports);
+                break;
+            case 4u:
+                device->process_saturated(context, &params, nullptr, input_ports, output_ports);
+                break;
+            default:
+                device->process(context, &params, nullptr, input_ports, output_ports);
+                break;
+            }
+        });
+    };
+
+    task_time = std::numeric_limits<double>::max();
+    double reference_time = std::numeric_limits<double>::max();
+    for (uint32_t r = 0; r < options.repetitions; ++r) {
+        task_time = std::min(task_time, MeasureBest(1u, launch));
+        reference_time = std::min(reference_time, MeasureBest(1u, [&] { RunReference(settings, params, input, output, counters); }));
+    }
+    return task_time / reference_time;
+}
+
+} // namespace
+
+int RunReferenceBenchmark(const std::vector<std::string>& args) {
+    ReferenceOptions options;
+    for (size_t i = 0; i + 1 < args.size(); i += 2) {
+        if (args[i] == "--channels") {
+            options.channel_count = static_cast<uint32_t>(std::strtoul(args[i + 1].c_str(), nullptr, 10));
+        }
+        else if (args[i] == "--buffer-size") {
+            options.buffer_size = static_cast<uint32_t>(std::strtoul(args[i + 1].c_str(), nullptr, 10));
+        }
+        else if (args[i] == "--repetitions") {
+            options.repetitions = static_cast<uint32_t>(std::strtoul(args[i + 1].c_str(), nullptr, 10));
+        }
+        else if (args[i] == "--max-ratio") {
+            options.max_ratio = std::strtod(args[i + 1].c_str(), nullptr);
+        }
+    }
+    // the pair task needs complete pairs
+    if (options.channel_count == 0u || options.channel_count % 2u != 0u || options.buffer_size == 0u || options.repetitions == 0u) {
+        std::cerr << "reference: the channel count must be even and not 0, the buffer size and repetitions not 0" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << options.channel_count << " channels x " << options.buffer_size << " samples\n"
+              << "task                 launch [us]  time / reference\n";
+    bool regressed = false;
+    for (const ReferenceTask& task : Tasks()) {
+        double task_time;
+        const double ratio = TimeRatio(task, options, task_time);
+        const bool failed = options.max_ratio > 0.0 && ratio > options.max_ratio;
+        regressed = regressed || failed;
+        std::cout << std::left << std::setw(21) << task.name << std::right << std::fixed << std::setprecision(1) << std::setw(11)
+                  << task_time * 1e6 << std::setprecision(2) << std::setw(18) << ratio << (failed ? "  above --max-ratio" : "") << "\n";
+    }
+    return regressed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
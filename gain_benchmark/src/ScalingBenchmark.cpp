@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "Benchmark.h"
+
+#include "GainProcessor.cuh"
+#include "GainTaskSettings.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+namespace {
+
+struct ScalingOptions {
+    uint32_t channel_count {512u};
+    uint32_t buffer_size {4096u};
+    uint32_t threads_per_block {1u};
+    uint32_t max_threads {std::max(std::thread::hardware_concurrency(), 1u)};
+    uint32_t launches {20u};
+};
+
+// 1, 2, 4, ... up to and including `max_threads`
+std::vector<uint32_t> ThreadCounts(uint32_t max_threads) {
+    std::vector<uint32_t> counts;
+    for (uint32_t n = 1u; n < max_threads; n *= 2u) {
+        counts.push_back(n);
+    }
+    counts.push_back(max_threads);
+    return counts;
+}
+
+// Times the task of `settings` over the whole grid on pools of 1 to `max_threads` threads and prints a row per
+// thread count
+void PrintScaling(const char* task_name, GainTaskSettings& settings, uint32_t channel_count, uint32_t threads_per_block,
+    const ScalingOptions& options) {
+    const size_t samples = static_cast<size_t>(channel_count) * options.buffer_size;
+    std::vector<float> input(samples, 0.5f);
+    std::vector<float> output(samples);
+    std::vector<float> state(static_cast<size_t>(channel_count) * settings.GetStateSize());
+    float* input_ports[] = {input.data()};
+    float* output_ports[] = {output.data(), state.data()};
+
+    gain::emulation::EmulatedDevice<GainProcessorDevice<float>> device {options.buffer_size};
+    gain::emulation::LaunchConfig config {};
+    config.block_count = settings.GetBlockCount(channel_count);
+    config.thread_count = threads_per_block;
+    config.shared_mem_size = settings.GetSharedMemorySize(threads_per_block);
+    // `process` never synchronizes; the limiter's threads run as fibers between its barriers
+    config.sequential_threads = settings.GetTaskIndex() == 0u;
+
+    // the first launch starts the device state over, the timed ones carry it
+    gain::ProcessorParameter params {};
+    settings.PrepareChunk(channel_count, options.buffer_size, options.buffer_size, true, params);
+    const auto launch = [&] {
+        gain::emulation::Launch(config, [&](gain::emulation::HostContext& context) {
+            if (settings.GetTaskIndex() == 2u) {
+                device->process_limited(context, &params, nullptr, input_ports, output_ports);
+            }
+            else {
+                device->process(context, &params, nullptr, input_ports, output_ports);
+            }
+        });
+    };
+    launch();
+    settings.PrepareChunk(channel_count, options.buffer_size, options.buffer_size, false, params);
+
+    std::cout << task_name << ": " << channel_count << " channels x " << options.buffer_size << " samples, " << threads_per_block
+              << " emulated threads per block\n"
+              << "threads  launch [us]  samples/s   speedup  efficiency\n";
+    double single_thread_time {0.0};
+    for (uint32_t thread_count : ThreadCounts(options.max_threads)) {
+        // the launching thread runs blocks as well, so the pool adds one worker less
+        gain::emulation::WorkStealingPool pool {thread_count - 1u};
+        config.pool = &pool;
+        const double time = MeasureBest(5u, [&] {
+            for (uint32_t l = 0; l < options.launches; ++l) {
+                launch();
+            }
+        }) / options.launches;
+        if (thread_count == 1u) {
+            single_thread_time = time;
+        }
+        const double speedup = single_thread_time / time;
+        std::cout << std::setw(7) << thread_count << std::fixed << std::setprecision(1) << std::setw(13) << time * 1e6
+                  << std::scientific << std::setprecision(2) << std::setw(11) << static_cast<double>(samples) / time
+                  << std::fixed << std::setw(9) << speedup << std::setw(11) << std::setprecision(0) << 100.0 * speedup / thread_count << "%\n";
+    }
+}
+
+} // namespace
+
+int RunScalingBenchmark(const std::vector<std::string>& args) {
+    ScalingOptions options;
+    for (size_t i = 0; i + 1 < args.size(); i += 2) {
+        const uint32_t value = static_cast<uint32_t>(std::strtoul(args[i + 1].c_str(), nullptr, 10));
+        if (args[i] == "--channels") {
+            options.channel_count = value;
+        }
+        else if (args[i] == "--buffer-size") {
+            options.buffer_size = value;
+        }
+        else if (args[i] == "--threads-per-block") {
+            options.threads_per_block = value;
+        }
+        else if (args[i] == "--max-threads") {
+            options.max_threads = value;
+        }
+        else if (args[i] == "--launches") {
+            options.launches = value;
+        }
+    }
+    if (options.channel_count == 0u || options.buffer_size == 0u || options.threads_per_block == 0u || options.max_threads == 0u ||
+        options.launches == 0u) {
+        std::cerr << "scaling: all options must be positive" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    GainConfig::Specification specification {};
+    specification.gain_value = 0.5f;
+    GainTaskSettings gain_settings {specification};
+    PrintScaling("process", gain_settings, options.channel_count, options.threads_per_block, options);
+
+    // The limiter synchronizes its threads, so it runs the block size of the processor (see LaunchTuning.h) rather
+    // than --threads-per-block; the gain drives it into gain reduction
+    specification.gain_value = 4.0f;
+    specification.limit = 1u;
+    GainTaskSettings limiter_settings {specification};
+    std::cout << "\n";
+    PrintScaling("process_limited", limiter_settings, options.channel_count,
+        limiter_settings.GetThreadCount(options.channel_count, options.buffer_size), options);
+    return EXIT_SUCCESS;
+}
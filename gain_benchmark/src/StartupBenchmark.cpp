@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "Benchmark.h"
+
+#include <os_utilities/LibraryLoader.h>
+#include <processor_api/ModuleInfoProvider.h>
+#include <processor_api/PlatformInfo.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+
+typedef GPUA::processor::v2::ErrorCode (*CreateModuleInfoProviderType)(GPUA::processor::v2::ModuleInfoProvider*& info_provider);
+typedef GPUA::processor::v2::ErrorCode (*DeleteModuleInfoProviderType)(GPUA::processor::v2::ModuleInfoProvider*);
+
+struct StartupTimes {
+    // module load and symbol lookup
+    double load;
+    // info provider creation and queries of all platforms and the processor entry names
+    double query;
+};
+
+bool MeasureStartup(const std::filesystem::path& path, StartupTimes& times) {
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+
+    NativeHandle handle = OpenLibrary(path);
+    if (handle == nullptr) {
+        return false;
+    }
+    auto create = reinterpret_cast<CreateModuleInfoProviderType>(GetLibraryFunction(handle, "CreateModuleInfoProvider_v2"));
+    auto destroy = reinterpret_cast<DeleteModuleInfoProviderType>(GetLibraryFunction(handle, "DeleteModuleInfoProvider_v2"));
+    const auto loaded = clock::now();
+
+    GPUA::processor::v2::ModuleInfoProvider* provider {nullptr};
+    if (!create || !destroy || create(provider) != GPUA::processor::v2::ErrorCode::eSuccess) {
+        CloseLibrary(handle);
+        return false;
+    }
+    bool success = true;
+    const uint32_t platform_count = provider->GetSupportPlatformCount();
+    for (uint32_t i = 0; i < platform_count; ++i) {
+        const GPUA::processor::v2::PlatformInfo* platform_info {nullptr};
+        success &= provider->GetSupportPlatformInfo(i, platform_info) == GPUA::processor::v2::ErrorCode::eSuccess;
+    }
+    const GPUA::processor::v2::ProcessorEntryInfo* entry_info {nullptr};
+    success &= provider->GetProcessorExecutionInfo(entry_info) == GPUA::processor::v2::ErrorCode::eSuccess;
+    const auto queried = clock::now();
+
+    destroy(provider);
+    CloseLibrary(handle);
+    times.load = std::chrono::duration<double>(loaded - start).count();
+    times.query = std::chrono::duration<double>(queried - loaded).count();
+    return success;
+}
+
+double Median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2u];
+}
+
+} // namespace
+
+int RunStartupBenchmark(const std::vector<std::string>& args) {
+    if (args.empty()) {
+        std::cerr << "startup: missing module path" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::string& path = args[0];
+    uint32_t repetitions {100u};
+    for (size_t i = 1; i < args.size(); ++i) {
+        if (args[i] == "--repetitions" && i + 1 < args.size()) {
+            repetitions = std::max(1, std::atoi(args[++i].c_str()));
+        }
+    }
+
+    // The OS loader keeps a library mapped as long as it is referenced (and sometimes beyond), so loading the same
+    // path again measures nothing. Every repetition loads its own copy of the module to get a fresh image with
+    // relocations and static initialization, like the first load of a session.
+    std::error_code error;
+    const std::filesystem::path copy = std::filesystem::temp_directory_path(error) / std::filesystem::path(path).filename();
+    std::vector<double> load_times;
+    std::vector<double> query_times;
+    for (uint32_t r = 0; r < repetitions; ++r) {
+        std::filesystem::path repetition_copy = copy;
+        repetition_copy += "." + std::to_string(r);
+        std::filesystem::copy_file(path, repetition_copy, std::filesystem::copy_options::overwrite_existing, error);
+        if (error) {
+            std::cerr << "startup: failed to copy " << path << ": " << error.message() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        StartupTimes times {};
+        const bool success = MeasureStartup(repetition_copy, times);
+        std::filesystem::remove(repetition_copy, error);
+        if (!success) {
+            std::cerr << "startup: failed to load " << path << " or to query its module info" << std::endl;
+            return EXIT_FAILURE;
+        }
+        load_times.push_back(times.load);
+        query_times.push_back(times.query);
+    }
+
+    constexpr double us {1e6};
+    std::cout << "load:  median " << Median(load_times) * us << " us, min " << *std::min_element(load_times.begin(), load_times.end()) * us << " us\n"
+              << "query: median " << Median(query_times) * us << " us, min " << *std::min_element(query_times.begin(), query_times.end()) * us << " us\n"
+              << "(" << repetitions << " repetitions)" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "Benchmark.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void PrintUsage() {
+    std::cout << "usage: gain_benchmark <benchmark> [options]\n"
+              << "  autotune [--max-block-size <n>]\n"
+              << "                               emulated launch times of the gain task per block size\n"
+              << "  startup <module> [--repetitions <n>]\n"
+              << "                               time from module load to the supported platform info\n"
+              << "  scaling [--channels <n>] [--buffer-size <n>] [--threads-per-block <n>] [--max-threads <n>] [--launches <n>]\n"
+              << "                               speedup of the emulated gain task grid from 1 to max threads\n"
+              << "  reference [--channels <n>] [--buffer-size <n>] [--repetitions <n>] [--max-ratio <r>]\n"
+              << "                               time of each emulated task relative to its scalar reference\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+
+    const std::string benchmark {argv[1]};
+    const std::vector<std::string> args(argv + 2, argv + argc);
+    if (benchmark == "autotune") {
+        return RunAutotuneBenchmark(args);
+    }
+    if (benchmark == "startup") {
+        return RunStartupBenchmark(args);
+    }
+    if (benchmark == "scaling") {
+        return RunScalingBenchmark(args);
+    }
+    if (benchmark == "reference") {
+        return RunReferenceBenchmark(args);
+    }
+
+    PrintUsage();
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,69 @@
+# Find dependencies
+find_package(Threads REQUIRED)
+find_package(processor_api CONFIG)
+find_package(processor_utilities CONFIG)
+
+# Component name.
+set(component_id ${effect_name})
+BG_FirstCaseUpper(component_id_capitalized "${component_id}")
+set(component_name ${component_id}_offline)
+
+# Component type (library or executable).
+# The offline renderer runs the device code of the processor in the host emulation,
+# so it is a plain host executable on every platform.
+set(component_type executable)
+
+# target libraries
+set(private_target_libraries
+    Threads::Threads
+    processor_api::processor_api
+    processor_utilities::processor_utilities
+)
+
+# compile definitions
+if(WIN32)
+    set(win_private_compile_definitions
+        WIN32_LEAN_AND_MEAN
+        NOMINMAX
+        WIN32
+        WIN64
+    )
+endif()
+
+set(private_compile_definitions
+    ${win_private_compile_definitions}
+    GAIN_HOST_EMULATION
+)
+
+# List of private include directories.
+# The device processor and the host emulation are shared with the processor component.
+set(private_include_directories
+    src
+    ../${component_id}_processor/include
+    ../${component_id}_processor/src
+    ../${component_id}_processor/src/cuda
+    ../${component_id}_processor/src/emulation
+)
+
+# List of private header files.
+set(private_headers
+    src/AudioFile.h
+    src/${component_id_capitalized}OfflineRenderer.h
+    src/MappedFile.h
+)
+
+# List of source files.
+# The processor's task settings (and the gain ramp, taper, limiter, pair and oversampler behind them) are compiled
+# in as well, so offline renders set up every launch exactly like the processor.
+set(sources
+    ../${component_id}_processor/src/${component_id_capitalized}Limiter.cpp
+    ../${component_id}_processor/src/${component_id_capitalized}Oversampler.cpp
+    ../${component_id}_processor/src/${component_id_capitalized}Pair.cpp
+    ../${component_id}_processor/src/${component_id_capitalized}Ramp.cpp
+    ../${component_id}_processor/src/${component_id_capitalized}Taper.cpp
+    ../${component_id}_processor/src/${component_id_capitalized}TaskSettings.cpp
+    src/AudioFile.cpp
+    src/${component_id_capitalized}OfflineRenderer.cpp
+    src/MappedFile.cpp
+    src/main.cpp
+)
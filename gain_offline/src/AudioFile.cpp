@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "AudioFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr uint16_t g_wave_format_ieee_float {0x0003u};
+constexpr uint16_t g_wave_format_extensible {0xFFFEu};
+// chunk size of RF64 files whose actual size is in the ds64 chunk
+constexpr uint32_t g_rf64_size_placeholder {0xFFFFFFFFu};
+// "RIFF" + size + "WAVE", "fmt " chunk (16 bytes of WAVEFORMAT + bits per sample), "data" chunk header
+constexpr uint64_t g_riff_header_size {12u + 24u + 8u};
+// the same plus the "ds64" chunk: RIFF size, data size, sample count and an empty chunk table
+constexpr uint64_t g_ds64_chunk_size {28u};
+constexpr uint64_t g_rf64_header_size {g_riff_header_size + 8u + g_ds64_chunk_size};
+
+uint16_t ReadU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t ReadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t ReadU64(const uint8_t* p) {
+    return static_cast<uint64_t>(ReadU32(p)) | (static_cast<uint64_t>(ReadU32(p + 4)) << 32);
+}
+
+bool IsTag(const uint8_t* p, const char* tag) {
+    return std::memcmp(p, tag, 4) == 0;
+}
+
+uint8_t* WriteTag(uint8_t* p, const char* tag) {
+    std::memcpy(p, tag, 4);
+    return p + 4;
+}
+
+uint8_t* WriteU16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+    return p + 2;
+}
+
+uint8_t* WriteU32(uint8_t* p, uint32_t value) {
+    return WriteU16(WriteU16(p, static_cast<uint16_t>(value)), static_cast<uint16_t>(value >> 16));
+}
+
+uint8_t* WriteU64(uint8_t* p, uint64_t value) {
+    return WriteU32(WriteU32(p, static_cast<uint32_t>(value)), static_cast<uint32_t>(value >> 32));
+}
+
+uint64_t GetDataSize(uint64_t frame_count, uint32_t channel_count) {
+    return frame_count * channel_count * sizeof(float);
+}
+
+bool NeedsRf64(uint64_t frame_count, uint32_t channel_count) {
+    // the RIFF size counts everything after its own field
+    return g_riff_header_size - 8u + GetDataSize(frame_count, channel_count) > UINT32_MAX;
+}
+
+} // namespace
+
+bool IsWav(const uint8_t* data, uint64_t size) {
+    return size >= 12u && (IsTag(data, "RIFF") || IsTag(data, "RF64")) && IsTag(data + 8, "WAVE");
+}
+
+AudioFileLayout ParseWavLayout(const uint8_t* data, uint64_t size) {
+    if (!IsWav(data, size)) {
+        throw std::runtime_error("Error in ParseWavLayout: not a RIFF/WAVE file");
+    }
+
+    AudioFileLayout layout {};
+    bool has_format = false;
+    // RF64 files carry the 64-bit size of the data chunk in the ds64 chunk, which comes first
+    const bool is_rf64 = IsTag(data, "RF64");
+    uint64_t rf64_data_size = 0u;
+    bool has_ds64 = false;
+    uint64_t pos = 12u;
+    // walk the chunk list until the data chunk; chunks are padded to an even size
+    while (pos + 8u <= size) {
+        const uint8_t* chunk = data + pos;
+        const uint64_t chunk_size = ReadU32(chunk + 4);
+        const uint64_t body = pos + 8u;
+
+        if (IsTag(chunk, "ds64")) {
+            if (chunk_size < g_ds64_chunk_size || body + chunk_size > size) {
+                throw std::runtime_error("Error in ParseWavLayout: truncated ds64 chunk");
+            }
+            rf64_data_size = ReadU64(data + body + 8);
+            has_ds64 = true;
+        }
+        else if (IsTag(chunk, "fmt ")) {
+            if (chunk_size < 16u || body + chunk_size > size) {
+                throw std::runtime_error("Error in ParseWavLayout: truncated fmt chunk");
+            }
+            uint16_t format = ReadU16(data + body);
+            const uint16_t bits_per_sample = ReadU16(data + body + 14);
+            if (format == g_wave_format_extensible && chunk_size >= 40u) {
+                // the first two bytes of the sub-format GUID carry the actual format tag
+                format = ReadU16(data + body + 24);
+            }
+            if (format != g_wave_format_ieee_float || bits_per_sample != 32u) {
+                throw std::runtime_error("Error in ParseWavLayout: only 32-bit float WAV files are supported");
+            }
+            layout.channel_count = ReadU16(data + body + 2);
+            layout.sample_rate = ReadU32(data + body + 4);
+            has_format = true;
+        }
+        else if (IsTag(chunk, "data")) {
+            if (!has_format || layout.channel_count == 0u) {
+                throw std::runtime_error("Error in ParseWavLayout: data chunk before fmt chunk");
+            }
+            if (is_rf64 && !has_ds64) {
+                throw std::runtime_error("Error in ParseWavLayout: RF64 file without ds64 chunk");
+            }
+            const uint64_t declared_size = is_rf64 && chunk_size == g_rf64_size_placeholder ? rf64_data_size : chunk_size;
+            // tolerate writers that leave the size of a streamed data chunk open
+            const uint64_t data_size = std::min<uint64_t>(declared_size, size - body);
+            layout.data_offset = body;
+            layout.frame_count = data_size / (sizeof(float) * layout.channel_count);
+            return layout;
+        }
+        pos = body + chunk_size + (chunk_size & 1u);
+    }
+    throw std::runtime_error("Error in ParseWavLayout: no data chunk found");
+}
+
+uint64_t GetWavHeaderSize(uint64_t frame_count, uint32_t channel_count) {
+    return NeedsRf64(frame_count, channel_count) ? g_rf64_header_size : g_riff_header_size;
+}
+
+void WriteWavHeader(uint8_t* data, const AudioFileLayout& layout) {
+    const uint64_t data_size = GetDataSize(layout.frame_count, layout.channel_count);
+    const bool rf64 = NeedsRf64(layout.frame_count, layout.channel_count);
+    const uint64_t riff_size = GetWavHeaderSize(layout.frame_count, layout.channel_count) - 8u + data_size;
+    if (layout.data_offset != GetWavHeaderSize(layout.frame_count, layout.channel_count)) {
+        throw std::runtime_error("Error in WriteWavHeader: the samples must follow the header");
+    }
+
+    uint8_t* p = WriteTag(data, rf64 ? "RF64" : "RIFF");
+    p = WriteU32(p, rf64 ? g_rf64_size_placeholder : static_cast<uint32_t>(riff_size));
+    p = WriteTag(p, "WAVE");
+    if (rf64) {
+        p = WriteTag(p, "ds64");
+        p = WriteU32(p, static_cast<uint32_t>(g_ds64_chunk_size));
+        p = WriteU64(p, riff_size);
+        p = WriteU64(p, data_size);
+        p = WriteU64(p, layout.frame_count);
+        p = WriteU32(p, 0u);
+    }
+    const uint16_t block_align = static_cast<uint16_t>(layout.channel_count * sizeof(float));
+    p = WriteTag(p, "fmt ");
+    p = WriteU32(p, 16u);
+    p = WriteU16(p, g_wave_format_ieee_float);
+    p = WriteU16(p, static_cast<uint16_t>(layout.channel_count));
+    p = WriteU32(p, layout.sample_rate);
+    p = WriteU32(p, layout.sample_rate * block_align);
+    p = WriteU16(p, block_align);
+    p = WriteU16(p, 32u);
+    p = WriteTag(p, "data");
+    WriteU32(p, rf64 ? g_rf64_size_placeholder : static_cast<uint32_t>(data_size));
+}
+
+AudioFileLayout MakeRawLayout(uint64_t size, uint32_t channel_count, uint32_t sample_rate) {
+    if (channel_count == 0u) {
+        throw std::runtime_error("Error in MakeRawLayout: channel count must not be 0");
+    }
+    AudioFileLayout layout {};
+    layout.data_offset = 0u;
+    layout.channel_count = channel_count;
+    layout.sample_rate = sample_rate;
+    layout.frame_count = size / (sizeof(float) * channel_count);
+    return layout;
+}
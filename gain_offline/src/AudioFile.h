@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_AUDIO_FILE_H
+#define GAIN_AUDIO_FILE_H
+
+#include <cstdint>
+
+// Location and format of the interleaved 32-bit float samples inside a mapped file
+struct AudioFileLayout {
+    uint64_t data_offset {0u};
+    uint64_t frame_count {0u};
+    uint32_t channel_count {0u};
+    uint32_t sample_rate {0u};
+};
+
+// Parses the RIFF/WAVE (or RF64/WAVE) header of a 32-bit float WAV file (WAVE_FORMAT_IEEE_FLOAT or
+// WAVE_FORMAT_EXTENSIBLE with float sub-format). Throws std::runtime_error if the file is no such WAV file.
+AudioFileLayout ParseWavLayout(const uint8_t* data, uint64_t size);
+
+// Size of the header WriteWavHeader writes for `frame_count` frames of `channel_count` channels: a RIFF/WAVE
+// header, or an RF64/WAVE header with a ds64 chunk (EBU Tech 3306) if the file exceeds the 4 GB of RIFF
+uint64_t GetWavHeaderSize(uint64_t frame_count, uint32_t channel_count);
+
+// Writes the header of a 32-bit float WAV file (WAVE_FORMAT_IEEE_FLOAT) for the frame count, channel count and
+// sample rate of `layout` to `data` (GetWavHeaderSize bytes); the samples follow at layout.data_offset
+void WriteWavHeader(uint8_t* data, const AudioFileLayout& layout);
+
+// Describes a headerless file of interleaved 32-bit float samples
+AudioFileLayout MakeRawLayout(uint64_t size, uint32_t channel_count, uint32_t sample_rate);
+
+// Returns true if the data starts with a RIFF/WAVE or RF64/WAVE header
+bool IsWav(const uint8_t* data, uint64_t size);
+
+#endif // GAIN_AUDIO_FILE_H
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "GainOfflineRenderer.h"
+
+#include "GainProcessor.cuh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+class GainOfflineRenderer::Device : public gain::emulation::EmulatedDevice<GainProcessorDevice<float>> {
+public:
+    using EmulatedDevice::EmulatedDevice;
+};
+
+GainOfflineRenderer::GainOfflineRenderer(const GainConfig::Specification& specification, uint32_t channel_count, uint32_t capacity, uint32_t threads_per_block,
+    uint32_t jobs) :
+    m_settings {specification},
+    m_channel_count {channel_count},
+    m_capacity {capacity},
+    // the launch geometry of GainProcessor::OnBlueprintRebuild unless a block size is given
+    m_threads_per_block {threads_per_block != 0u ? threads_per_block : m_settings.GetThreadCount(channel_count, capacity)},
+    m_pool {jobs > 1u ? std::make_unique<gain::emulation::WorkStealingPool>(jobs - 1u) : nullptr},
+    m_input(static_cast<size_t>(channel_count) * capacity),
+    m_output(static_cast<size_t>(channel_count) * capacity),
+    m_counters(channel_count),
+    m_state(static_cast<size_t>(channel_count) * m_settings.GetStateSize()),
+    m_device {std::make_unique<Device>(capacity)} {
+    if (channel_count == 0u || capacity == 0u) {
+        throw std::runtime_error("Error in GainOfflineRenderer::GainOfflineRenderer: channel count and capacity must not be 0");
+    }
+    // the same restrictions as GainProcessor::Create and GainInputPort
+    if (!GainTaskSettings::IsSupported(specification)) {
+        throw std::runtime_error("Error in GainOfflineRenderer::GainOfflineRenderer: the specification combines modes no task implements");
+    }
+    if (channel_count % m_settings.GetChannelMultiple() != 0u) {
+        throw std::runtime_error("Error in GainOfflineRenderer::GainOfflineRenderer: pair modes need an even channel count");
+    }
+    m_stats.sanitized.resize(channel_count);
+}
+
+GainOfflineRenderer::~GainOfflineRenderer() = default;
+
+void GainOfflineRenderer::Process(const uint8_t* input, uint8_t* output, uint64_t frame_count) {
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint64_t frame = 0u; frame < frame_count; frame += m_capacity) {
+        const uint32_t grain = static_cast<uint32_t>(std::min<uint64_t>(m_capacity, frame_count - frame));
+        const uint64_t offset = frame * m_channel_count * sizeof(float);
+        ProcessGrain(input + offset, output + offset, grain);
+        ++m_stats.grains;
+    }
+
+    m_stats.frames += frame_count;
+    m_stats.samples += frame_count * m_channel_count;
+    m_stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void GainOfflineRenderer::ProcessGrain(const uint8_t* input, uint8_t* output, uint32_t frame_count) {
+    // de-interleave into the planar port layout; the samples are copied bytewise as they need not be aligned
+    for (uint32_t f = 0; f < frame_count; ++f) {
+        for (uint32_t c = 0; c < m_channel_count; ++c) {
+            std::memcpy(&m_input[static_cast<size_t>(c) * m_capacity + f], input + (static_cast<size_t>(f) * m_channel_count + c) * sizeof(float),
+                sizeof(float));
+        }
+    }
+
+    // set the processor parameter through the same GainTaskSettings as GainProcessor::PrepareChunk
+    gain::ProcessorParameter proc_params {};
+    m_settings.PrepareChunk(m_channel_count, m_capacity, frame_count, m_reset_state, proc_params);
+    m_reset_state = false;
+
+    float* input_ports[] = {m_input.data()};
+    // the output ports in the order GainProcessor::Create creates them: the counters only if sanitizing
+    float* output_ports[3] = {m_output.data(), reinterpret_cast<float*>(m_counters.data())};
+    output_ports[m_settings.GetStatePort()] = m_state.data();
+
+    // the launch geometry of GainProcessor::OnBlueprintRebuild, with the given block size
+    gain::emulation::LaunchConfig config {};
+    config.block_count = m_settings.GetBlockCount(m_channel_count);
+    config.thread_count = m_threads_per_block;
+    config.shared_mem_size = m_settings.GetSharedMemorySize(m_threads_per_block);
+    config.pool = m_pool.get();
+    const uint32_t task = m_settings.GetTaskIndex();
+    gain::emulation::Launch(config, [&](gain::emulation::HostContext& context) {
+        auto& device = *m_device;
+        switch (task) {
+        case 1u:
+            device->process_sanitized(context, &proc_params, nullptr, input_ports, output_ports);
+            break;
+        case 2u:
+            device->process_limited(context, &proc_params, nullptr, input_ports, output_ports);
+            break;
+        case 3u:
+            device->process_pair(context, &proc_params, nullptr, input_ports, output_ports);
+            break;
+        case 4u:
+            device->process_saturated(context, &proc_params, nullptr, input_ports, output_ports);
+            break;
+        default:
+            device->process(context, &proc_params, nullptr, input_ports, output_ports);
+            break;
+        }
+    });
+    if (m_settings.IsSanitizing()) {
+        for (uint32_t c = 0; c < m_channel_count; ++c) {
+            m_stats.sanitized[c] += m_counters[c];
+        }
+    }
+
+    // interleave the result
+    for (uint32_t f = 0; f < frame_count; ++f) {
+        for (uint32_t c = 0; c < m_channel_count; ++c) {
+            std::memcpy(output + (static_cast<size_t>(f) * m_channel_count + c) * sizeof(float), &m_output[static_cast<size_t>(c) * m_capacity + f],
+                sizeof(float));
+        }
+    }
+}
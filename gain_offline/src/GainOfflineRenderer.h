@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_GAIN_OFFLINE_RENDERER_H
+#define GAIN_GAIN_OFFLINE_RENDERER_H
+
+#include "GainTaskSettings.h"
+
+#include <gain_processor/GainSpecification.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace gain::emulation {
+class WorkStealingPool;
+}
+
+struct GainOfflineStats {
+    uint64_t frames {0u};
+    uint64_t samples {0u};
+    uint64_t grains {0u};
+    double seconds {0.0};
+    // number of sanitized samples per channel (only counted if `Specification::sanitize` is set)
+    std::vector<uint64_t> sanitized;
+};
+
+// Streams interleaved float audio through the device-side gain processor in capacity-sized grains.
+// The device tasks run in the host emulation, i.e., exactly the code that is compiled for the GPU.
+class GainOfflineRenderer {
+public:
+    // `capacity` corresponds to the capacity of the processor's input port (samples per channel); the blocks
+    // (channels) of a grain run on `jobs` threads, including the calling one. A `threads_per_block` of 0 takes the
+    // block size the processor launches with (GainTaskSettings::GetThreadCount)
+    GainOfflineRenderer(const GainConfig::Specification& specification, uint32_t channel_count, uint32_t capacity, uint32_t threads_per_block,
+        uint32_t jobs = 1u);
+    ~GainOfflineRenderer();
+
+    // Copy ctor and copy assignment are deleted along with move assignment operator deletion
+    GainOfflineRenderer& operator=(GainOfflineRenderer&&) = delete;
+
+    // processes `frame_count` interleaved float frames from `input` into `output` (may alias); the samples need not be
+    // aligned, e.g., in the data chunk of a WAV file with an 18 byte fmt chunk
+    void Process(const uint8_t* input, uint8_t* output, uint64_t frame_count);
+
+    const GainOfflineStats& GetStats() const noexcept { return m_stats; }
+
+private:
+    void ProcessGrain(const uint8_t* input, uint8_t* output, uint32_t frame_count);
+
+    class Device;
+
+    // fills the processor parameter of every grain like GainProcessor::PrepareChunk
+    GainTaskSettings m_settings;
+    uint32_t m_channel_count;
+    uint32_t m_capacity;
+    uint32_t m_threads_per_block;
+    // the device state starts over with the first grain
+    bool m_reset_state {true};
+    // nullptr if all blocks run on the calling thread
+    std::unique_ptr<gain::emulation::WorkStealingPool> m_pool;
+
+    // planar staging buffers matching the device port layout: all samples of channel 0, then channel 1, ...
+    std::vector<float> m_input;
+    std::vector<float> m_output;
+    // the counter port of the sanitizing and limiting tasks, one counter per channel
+    std::vector<uint32_t> m_counters;
+    // the state port of the limiting and saturating tasks (GainTaskSettings::GetStateSize floats per channel)
+    std::vector<float> m_state;
+
+    std::unique_ptr<Device> m_device;
+    GainOfflineStats m_stats;
+};
+
+#endif // GAIN_GAIN_OFFLINE_RENDERER_H
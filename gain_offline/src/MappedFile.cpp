@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if !defined(WIN32)
+uint64_t PageAlignDown(uint64_t offset) {
+    static const uint64_t page_size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    return offset - offset % page_size;
+}
+#endif
+
+} // namespace
+
+#if defined(WIN32)
+
+MappedFile::MappedFile(const std::filesystem::path& path, Mode mode, uint64_t size) :
+    m_mode {mode} {
+    const bool writable = mode == Mode::eReadWrite;
+    HANDLE file = CreateFileW(path.c_str(), writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ, FILE_SHARE_READ, nullptr,
+        writable ? CREATE_ALWAYS : OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Error in MappedFile::MappedFile: can not open " + path.string());
+    }
+    m_file = file;
+
+    LARGE_INTEGER file_size {};
+    if (writable) {
+        file_size.QuadPart = static_cast<LONGLONG>(size);
+        if (!SetFilePointerEx(file, file_size, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+            CloseHandle(file);
+            throw std::runtime_error("Error in MappedFile::MappedFile: can not resize " + path.string());
+        }
+    }
+    else if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        throw std::runtime_error("Error in MappedFile::MappedFile: can not query size of " + path.string());
+    }
+    m_size = static_cast<uint64_t>(file_size.QuadPart);
+    if (m_size == 0u) {
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        throw std::runtime_error("Error in MappedFile::MappedFile: can not map " + path.string());
+    }
+    m_mapping = mapping;
+
+    m_data = static_cast<uint8_t*>(MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Error in MappedFile::MappedFile: can not map " + path.string());
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (m_data) {
+        if (m_mode == Mode::eReadWrite) {
+            FlushViewOfFile(m_data, 0);
+        }
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+    }
+    if (m_file) {
+        CloseHandle(m_file);
+    }
+}
+
+void MappedFile::Prefetch(uint64_t offset, uint64_t length) const noexcept {
+    if (m_data == nullptr || offset >= m_size) {
+        return;
+    }
+    WIN32_MEMORY_RANGE_ENTRY range {m_data + offset, static_cast<SIZE_T>(std::min(length, m_size - offset))};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+void MappedFile::Release(uint64_t offset, uint64_t length) const noexcept {
+    // the working set trimming of Windows takes care of pages that are not used any more
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& path, Mode mode, uint64_t size) :
+    m_mode {mode} {
+    const bool writable = mode == Mode::eReadWrite;
+    m_fd = open(path.c_str(), writable ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDONLY, 0644);
+    if (m_fd < 0) {
+        throw std::runtime_error("Error in MappedFile::MappedFile: can not open " + path.string());
+    }
+
+    if (writable) {
+        if (ftruncate(m_fd, static_cast<off_t>(size)) != 0) {
+            close(m_fd);
+            throw std::runtime_error("Error in MappedFile::MappedFile: can not resize " + path.string());
+        }
+        m_size = size;
+    }
+    else {
+        struct stat file_stat {};
+        if (fstat(m_fd, &file_stat) != 0) {
+            close(m_fd);
+            throw std::runtime_error("Error in MappedFile::MappedFile: can not query size of " + path.string());
+        }
+        m_size = static_cast<uint64_t>(file_stat.st_size);
+    }
+    if (m_size == 0u) {
+        return;
+    }
+
+    void* data = mmap(nullptr, m_size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, m_fd, 0);
+    if (data == MAP_FAILED) {
+        close(m_fd);
+        throw std::runtime_error("Error in MappedFile::MappedFile: can not map " + path.string());
+    }
+    m_data = static_cast<uint8_t*>(data);
+    // the file is streamed front to back; let the kernel read ahead aggressively
+    madvise(m_data, m_size, MADV_SEQUENTIAL);
+}
+
+MappedFile::~MappedFile() {
+    if (m_data) {
+        munmap(m_data, m_size);
+    }
+    if (m_fd >= 0) {
+        close(m_fd);
+    }
+}
+
+void MappedFile::Prefetch(uint64_t offset, uint64_t length) const noexcept {
+    if (m_data == nullptr || offset >= m_size) {
+        return;
+    }
+    const uint64_t begin = PageAlignDown(offset);
+    madvise(m_data + begin, std::min(length + offset - begin, m_size - begin), MADV_WILLNEED);
+}
+
+void MappedFile::Release(uint64_t offset, uint64_t length) const noexcept {
+    if (m_data == nullptr || offset >= m_size) {
+        return;
+    }
+    const uint64_t begin = PageAlignDown(offset);
+    const uint64_t range = std::min(length + offset - begin, m_size - begin);
+    if (m_mode == Mode::eReadWrite) {
+        // write back asynchronously so dirty pages of multi-hour renders do not pile up
+        msync(m_data + begin, range, MS_ASYNC);
+    }
+    else {
+        madvise(m_data + begin, range, MADV_DONTNEED);
+    }
+}
+
+#endif
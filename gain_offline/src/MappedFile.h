@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_MAPPED_FILE_H
+#define GAIN_MAPPED_FILE_H
+
+#include <cstdint>
+#include <filesystem>
+
+// Memory mapping of a whole file. Read-only mappings open an existing file, writable
+// mappings create (or truncate) the file with the requested size.
+class MappedFile {
+public:
+    enum class Mode {
+        eReadOnly,
+        eReadWrite
+    };
+
+    // throws std::runtime_error if the file can not be opened, sized or mapped
+    MappedFile(const std::filesystem::path& path, Mode mode, uint64_t size = 0u);
+    ~MappedFile();
+
+    // Copy ctor and copy assignment are deleted along with move assignment operator deletion
+    MappedFile& operator=(MappedFile&&) = delete;
+
+    uint8_t* data() const noexcept { return m_data; }
+    uint64_t size() const noexcept { return m_size; }
+
+    // hint to the OS that `[offset, offset + length)` will be read sequentially and soon
+    void Prefetch(uint64_t offset, uint64_t length) const noexcept;
+    // hint to the OS that `[offset, offset + length)` is not needed any more
+    void Release(uint64_t offset, uint64_t length) const noexcept;
+
+private:
+    uint8_t* m_data {nullptr};
+    uint64_t m_size {0u};
+    Mode m_mode;
+
+#if defined(WIN32)
+    void* m_file {nullptr};
+    void* m_mapping {nullptr};
+#else
+    int m_fd {-1};
+#endif
+};
+
+#endif // GAIN_MAPPED_FILE_H
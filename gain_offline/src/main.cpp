@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "AudioFile.h"
+#include "GainOfflineRenderer.h"
+#include "MappedFile.h"
+
+#include <gain_processor/GainSpecification.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace {
+
+struct Options {
+    std::string input;
+    std::string output;
+    float gain {1.0f};
+    GainConfig::GainUnit gain_unit {GainConfig::GainUnit::eLinear};
+    uint32_t capacity {4096u};
+    // 0: the block size of the processor's launches
+    uint32_t threads_per_block {0u};
+    uint32_t jobs {1u};
+    bool sanitize {false};
+    bool limit {false};
+    float limiter_ceiling {-1.0f};
+    uint32_t limiter_lookahead {240u};
+    // only used for raw files; WAV files carry their own format
+    uint32_t channel_count {0u};
+    uint32_t sample_rate {0u};
+};
+
+void PrintUsage() {
+    std::cout << "usage: gain_offline <input.wav|input.raw> <output> [options]\n"
+              << "  --gain <linear gain>          gain applied to every sample (default 1.0)\n"
+              << "  --gain-db <decibel>           gain in dB instead of a linear gain\n"
+              << "  --capacity <samples>          samples per channel per grain (default 4096)\n"
+              << "  --threads-per-block <count>   emulated threads per block (default: as launched by the processor)\n"
+              << "  --jobs <count>                threads that render the channels in parallel (default 1)\n"
+              << "  --sanitize                    flush subnormals and replace NaN/Inf with zero\n"
+              << "  --limit <ceiling dBFS>        brickwall limiter after the gain; delays the output by the look-ahead\n"
+              << "  --lookahead <samples>         look-ahead of the limiter (default 240)\n"
+              << "  --channels <count>            channel count of raw input (required for raw)\n"
+              << "  --sample-rate <hz>            sample rate of raw input (for the realtime factor)\n";
+}
+
+Options ParseOptions(int argc, char** argv) {
+    Options options;
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg {argv[i]};
+        const bool has_value = i + 1 < argc;
+        if (arg == "--gain" && has_value) {
+            options.gain = std::strtof(argv[++i], nullptr);
+            options.gain_unit = GainConfig::GainUnit::eLinear;
+        }
+        else if (arg == "--gain-db" && has_value) {
+            options.gain = std::strtof(argv[++i], nullptr);
+            options.gain_unit = GainConfig::GainUnit::eDecibel;
+        }
+        else if (arg == "--capacity" && has_value) {
+            options.capacity = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--threads-per-block" && has_value) {
+            options.threads_per_block = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--jobs" && has_value) {
+            options.jobs = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--sanitize") {
+            options.sanitize = true;
+        }
+        else if (arg == "--limit" && has_value) {
+            options.limit = true;
+            options.limiter_ceiling = std::strtof(argv[++i], nullptr);
+        }
+        else if (arg == "--lookahead" && has_value) {
+            options.limiter_lookahead = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--channels" && has_value) {
+            options.channel_count = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--sample-rate" && has_value) {
+            options.sample_rate = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (positional == 0) {
+            options.input = arg;
+            ++positional;
+        }
+        else if (positional == 1) {
+            options.output = arg;
+            ++positional;
+        }
+        else {
+            throw std::invalid_argument("unknown argument " + arg);
+        }
+    }
+    if (positional != 2 || options.capacity == 0u) {
+        throw std::invalid_argument("missing or invalid arguments");
+    }
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        options = ParseOptions(argc, argv);
+    }
+    catch (const std::exception& exc) {
+        std::cerr << exc.what() << std::endl;
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+
+    try {
+        // the output is created (or truncated) before the input is read
+        std::error_code error;
+        if (std::filesystem::equivalent(options.input, options.output, error)) {
+            throw std::runtime_error("Error in main: the output " + options.output + " is the input file");
+        }
+        const MappedFile input {options.input, MappedFile::Mode::eReadOnly};
+        const AudioFileLayout layout = IsWav(input.data(), input.size()) ?
+            ParseWavLayout(input.data(), input.size()) :
+            MakeRawLayout(input.size(), options.channel_count, options.sample_rate);
+
+        // WAV input gets a WAV output of the same format (RF64 if it exceeds 4 GB), raw input a raw output; other
+        // chunks of the input (e.g., metadata) are not copied
+        const bool is_wav = layout.data_offset > 0u;
+        AudioFileLayout output_layout {layout};
+        output_layout.data_offset = is_wav ? GetWavHeaderSize(layout.frame_count, layout.channel_count) : 0u;
+        const uint64_t data_size = layout.frame_count * layout.channel_count * sizeof(float);
+        MappedFile output {options.output, MappedFile::Mode::eReadWrite, output_layout.data_offset + data_size};
+        if (is_wav) {
+            WriteWavHeader(output.data(), output_layout);
+        }
+
+        GainConfig::Specification specification {};
+        specification.gain_value = options.gain;
+        specification.gain_unit = options.gain_unit;
+        specification.sanitize = options.sanitize ? 1u : 0u;
+        specification.limit = options.limit ? 1u : 0u;
+        specification.limiter_ceiling = options.limiter_ceiling;
+        specification.limiter_lookahead = options.limiter_lookahead;
+        GainOfflineRenderer renderer {specification, layout.channel_count, options.capacity, options.threads_per_block, options.jobs};
+
+        // stream in chunks of many grains so the mappings can be prefetched and released as we go
+        const uint64_t frames_per_chunk = static_cast<uint64_t>(options.capacity) * 64u;
+        const uint64_t frame_bytes = static_cast<uint64_t>(layout.channel_count) * sizeof(float);
+        for (uint64_t frame = 0u; frame < layout.frame_count; frame += frames_per_chunk) {
+            const uint64_t frames = std::min(frames_per_chunk, layout.frame_count - frame);
+            const uint64_t offset = layout.data_offset + frame * frame_bytes;
+            input.Prefetch(offset + frames * frame_bytes, frames_per_chunk * frame_bytes);
+            renderer.Process(input.data() + offset, output.data() + output_layout.data_offset + frame * frame_bytes, frames);
+            input.Release(offset, frames * frame_bytes);
+            output.Release(output_layout.data_offset + frame * frame_bytes, frames * frame_bytes);
+        }
+
+        const GainOfflineStats& stats = renderer.GetStats();
+        const double samples_per_second = stats.seconds > 0.0 ? static_cast<double>(stats.samples) / stats.seconds : 0.0;
+        std::cout << "rendered " << stats.frames << " frames x " << layout.channel_count << " channels in "
+                  << stats.grains << " grains (" << stats.seconds << " s)\n"
+                  << "throughput: " << samples_per_second << " samples/s";
+        if (layout.sample_rate != 0u && stats.seconds > 0.0) {
+            std::cout << " (" << static_cast<double>(stats.frames) / layout.sample_rate / stats.seconds << "x realtime)";
+        }
+        std::cout << std::endl;
+        if (options.sanitize) {
+            for (size_t c = 0; c < stats.sanitized.size(); ++c) {
+                if (stats.sanitized[c] != 0u) {
+                    std::cout << "channel " << c << ": " << stats.sanitized[c] << " samples sanitized" << std::endl;
+                }
+            }
+        }
+    }
+    catch (const std::exception& exc) {
+        std::cerr << exc.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -105,10 +105,18 @@ set(module_common_private_compile_definitions
     MODULE_PATCH_LEVEL=${${component_name}_PATCH_LEVEL}
 )
 
+# record processor lifecycle events to a Chrome trace file (see src/Trace.h)
+option(GAIN_TRACE "Trace the processor lifecycle in the Chrome trace event format" OFF)
+# serve device code from the directory in GAIN_DEVICE_CODE_DIR instead of the embedded binaries (see
+# src/GainDeviceCodeProvider.cpp); for development builds only
+option(GAIN_DEVICE_CODE_OVERRIDE "Let GAIN_DEVICE_CODE_DIR replace the embedded device code" OFF)
+
 set(common_private_compile_definitions
     ${win_common_private_compile_definitions}
     MODULE_IMPLEMENTATION
     ${module_common_private_compile_definitions}
+    $<$<BOOL:${GAIN_TRACE}>:GAIN_TRACE>
+    $<$<BOOL:${GAIN_DEVICE_CODE_OVERRIDE}>:GAIN_DEVICE_CODE_OVERRIDE>
 )
 
 if(APPLE)
@@ -223,11 +231,27 @@ endif()
 
 # List of private header files.
 set(common_private_headers
+    src/ArchList.h
+    src/DeviceCodeIndex.h
+    src/LaunchTuning.h
+    src/SlabPool.h
+    src/emulation/FiberScheduler.h
+    src/emulation/HostEmulation.h
+    src/emulation/WorkStealingPool.h
+    src/Trace.h
     src/${component_id_capitalized}DeviceCodeProvider.h
     src/${component_id_capitalized}InputPort.h
+    src/${component_id_capitalized}Limiter.h
     src/${component_id_capitalized}Module.h
     src/${component_id_capitalized}ModuleInfoProvider.h
+    src/${component_id_capitalized}Oversampler.h
+    src/${component_id_capitalized}Pair.h
     src/${component_id_capitalized}Processor.h
+    src/${component_id_capitalized}Ramp.h
+    src/${component_id_capitalized}Taper.h
+    src/${component_id_capitalized}TaskSettings.h
+    include/gain_processor/GainDeviceCode.h
+    include/gain_processor/GainMessageStream.h
     include/gain_processor/GainSpecification.h
 )
 
@@ -238,6 +262,8 @@ if(APPLE)
 
     set(device_metal_private_headers
         src/cuda/${component_id_capitalized}Processor.cuh
+        src/cuda/DeviceUtilities.cuh
+        src/cuda/OversamplingFilter.cuh
         src/cuda/Properties.h
     )
 else()
@@ -251,11 +277,15 @@ else()
 
     set(device_nvidia_private_headers
         src/cuda/${component_id_capitalized}Processor.cuh
+        src/cuda/DeviceUtilities.cuh
+        src/cuda/OversamplingFilter.cuh
         src/cuda/Properties.h
     )
 
     set(device_amd_private_headers
         src/cuda/${component_id_capitalized}Processor.cuh
+        src/cuda/DeviceUtilities.cuh
+        src/cuda/OversamplingFilter.cuh
         src/cuda/Properties.h
     )
 endif()
@@ -263,12 +293,20 @@ endif()
 # List of source files.
 
 set(common_sources
+    src/DeviceCodeIndex.cpp
     src/${component_id_capitalized}DeviceCodeProvider.cpp
     src/${component_id_capitalized}InputPort.cpp
+    src/${component_id_capitalized}Limiter.cpp
     src/${component_id_capitalized}Module.cpp
     src/${component_id_capitalized}ModuleInfoProvider.cpp
     src/${component_id_capitalized}ModuleLibrary.cpp
+    src/${component_id_capitalized}Oversampler.cpp
+    src/${component_id_capitalized}Pair.cpp
     src/${component_id_capitalized}Processor.cpp
+    src/${component_id_capitalized}Ramp.cpp
+    src/${component_id_capitalized}Taper.cpp
+    src/${component_id_capitalized}TaskSettings.cpp
+    src/Trace.cpp
 )
 
 if(APPLE)
@@ -300,6 +338,8 @@ endif()
 # List of test source files.
 set(common_test_private_compile_definitions
     ${win_common_private_compile_definitions}
+    # the golden tests run the device code in the host emulation
+    GAIN_HOST_EMULATION
 )
 
 if(APPLE)
@@ -317,6 +357,7 @@ else()
 endif()
 
 set(common_test_headers
+    tests/GainReference.h
     tests/TestCommon.h
 )
 
@@ -335,7 +376,32 @@ else()
 endif()
 
 set(common_test_sources
+    tests/${component_id_capitalized}DeviceCodeTests.cpp
+    tests/${component_id_capitalized}GoldenTests.cpp
+    tests/${component_id_capitalized}LimiterTests.cpp
+    tests/${component_id_capitalized}MessageStreamTests.cpp
     tests/${component_id_capitalized}ModuleInfoProviderTests.cpp
+    tests/${component_id_capitalized}OversamplerTests.cpp
+    tests/${component_id_capitalized}PairTests.cpp
+    tests/${component_id_capitalized}SanitizeTests.cpp
+    tests/${component_id_capitalized}TaperTests.cpp
+    tests/FiberSchedulerTests.cpp
+    tests/LaunchTuningTests.cpp
+    tests/SlabPoolTests.cpp
+    tests/OfflineFileTests.cpp
+    tests/WorkStealingPoolTests.cpp
+    # the host side of the tasks, as compiled into the module
+    src/${component_id_capitalized}Limiter.cpp
+    src/${component_id_capitalized}Oversampler.cpp
+    src/${component_id_capitalized}Pair.cpp
+    src/${component_id_capitalized}Ramp.cpp
+    src/${component_id_capitalized}Taper.cpp
+    src/${component_id_capitalized}TaskSettings.cpp
+    # the device code index, without the embedded code of the module
+    src/DeviceCodeIndex.cpp
+    # the file handling of the offline renderer is tested here as well
+    ../${component_id}_offline/src/AudioFile.cpp
+    ../${component_id}_offline/src/MappedFile.cpp
 )
 
 if(APPLE)
@@ -352,6 +418,27 @@ else()
     )
 endif()
 
+set(common_test_private_include_directories
+    src
+    src/cuda
+    src/emulation
+    ../${component_id}_offline/src
+)
+
+if(APPLE)
+    set(metal_test_private_include_directories
+        ${common_test_private_include_directories}
+    )
+else()
+    set(nvidia_test_private_include_directories
+        ${common_test_private_include_directories}
+    )
+
+    set(amd_test_private_include_directories
+        ${common_test_private_include_directories}
+    )
+endif()
+
 if(NOT APPLE)
     # TODO: Fix parallel test execution for AMD
     set(amd_test_properties
@@ -0,0 +1,44 @@
+# Content hashes of the embedded device code (see src/DeviceCodeIndex.h). Every binary in the resource library of
+# the component gets a resource next to it, named like the binary with the suffix ".fnv1a", that holds its
+# GainConfig::HashDeviceCode. The hash is computed when the binary is built, so the module returns it without
+# reading the blob.
+
+add_executable(${component_name}_device_code_hash
+    tools/DeviceCodeHash.cpp
+    src/DeviceCodeIndex.cpp
+)
+target_include_directories(${component_name}_device_code_hash PRIVATE
+    include
+    src
+)
+target_compile_features(${component_name}_device_code_hash PRIVATE cxx_std_17)
+
+# Adds the hash resources of the given device code binaries to the cmrc resource library with the namespace
+# `resource_namespace`, e.g., BG::gain_processor.
+function(gain_add_device_code_hashes resource_namespace)
+    set(hash_dir "${CMAKE_CURRENT_BINARY_DIR}/device_code_hashes")
+    set(hashes)
+    foreach(device_code IN LISTS ARGN)
+        get_filename_component(name "${device_code}" NAME)
+        set(hash "${hash_dir}/${name}.fnv1a")
+        add_custom_command(
+            OUTPUT "${hash}"
+            COMMAND ${CMAKE_COMMAND} -E make_directory "${hash_dir}"
+            COMMAND ${component_name}_device_code_hash "${device_code}" "${hash}"
+            DEPENDS "${device_code}" ${component_name}_device_code_hash
+            COMMENT "Hashing ${name}"
+            VERBATIM
+        )
+        list(APPEND hashes "${hash}")
+    endforeach()
+
+    # the resource libraries of the module targets (one per GPU platform)
+    get_property(targets DIRECTORY PROPERTY BUILDSYSTEM_TARGETS)
+    foreach(target IN LISTS targets)
+        get_target_property(is_resource_library ${target} CMRC_IS_RESOURCE_LIBRARY)
+        get_target_property(namespace ${target} CMRC_NAMESPACE)
+        if(is_resource_library AND namespace STREQUAL resource_namespace)
+            cmrc_add_resources(${target} WHENCE "${hash_dir}" ${hashes})
+        endif()
+    endforeach()
+endfunction()
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_GAIN_DEVICE_CODE_H
+#define GAIN_GAIN_DEVICE_CODE_H
+
+#include <cstdint>
+#include <stddef.h>
+
+namespace GainConfig {
+
+// Content hash of a device code blob (64-bit FNV-1a over its bytes). The module library exports
+//
+//     GPUA::processor::v2::ErrorCode GetDeviceCodeHash_v2(const GPUA::processor::v2::DeviceCodeSpecification&, uint64_t& hash)
+//
+// which returns the hash of the blob GainDeviceCodeProvider would serve for the specification, without creating a
+// stream; the hash of embedded code is computed when the module is built. An engine that keys its JIT and
+// registration caches by this hash can skip both when a module is reloaded with unchanged device code.
+constexpr uint64_t HashDeviceCode(const char* data, size_t size) noexcept {
+    uint64_t hash {0xCBF29CE484222325ull};
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+// environment variable naming a directory whose device code files (same names as the embedded ones, e.g.
+// libgain_processor.sm_86.cubin) replace the embedded binaries; for development only. Only read by modules built
+// with the CMake option GAIN_DEVICE_CODE_OVERRIDE. Files must be replaced atomically (written to a temporary file in
+// the same directory and renamed over the old one), never rewritten in place
+constexpr const char* g_device_code_dir_variable {"GAIN_DEVICE_CODE_DIR"};
+
+} // namespace GainConfig
+
+#endif // GAIN_GAIN_DEVICE_CODE_H
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_GAIN_MESSAGE_STREAM_H
+#define GAIN_GAIN_MESSAGE_STREAM_H
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stddef.h>
+
+namespace GainConfig {
+
+// Several messages in one GainProcessor::SetData call (or one LaunchData::app_data blob), e.g., all automation of a
+// launch. Layout (all fields little endian uint32_t, the blob 4-byte aligned):
+//
+//     MessageStream header | MessageRecord | payload | padding | MessageRecord | payload | padding | ...
+//
+// The payload of a record is one of the regular messages (Parameters, MidSideParameters, ...) including its
+// `ThisMessage` member, which must match `MessageRecord::message`; it is padded to a multiple of 4 bytes so the next
+// record is aligned. Records are applied in order, so later records win.
+//
+// Versioning: processors reject streams of a higher major version. Within a major version, newer messages may
+// append members to a payload (processors read the members they know) and new message ids may be added (processors
+// skip records they do not know).
+struct MessageStream {
+    static constexpr uint32_t MessageStreamMessage = 0xDE2F52B2;
+    static constexpr uint16_t MajorVersion = 1;
+    static constexpr uint16_t MinorVersion = 0;
+    uint32_t ThisMessage {MessageStreamMessage};
+
+    uint16_t major_version {MajorVersion};
+    uint16_t minor_version {MinorVersion};
+    // bytes of all records after the header, including padding
+    uint32_t size {};
+    uint32_t record_count {};
+};
+
+struct MessageRecord {
+    // `ThisMessage` id of the payload
+    uint32_t message {};
+    // bytes of the payload, without padding
+    uint32_t size {};
+};
+
+// Reads a message stream in place; nothing is copied or allocated.
+class MessageStreamReader {
+public:
+    struct Record {
+        uint32_t message;
+        const void* payload;
+        uint32_t size;
+    };
+
+    MessageStreamReader(const void* data, size_t data_size) noexcept :
+        m_data {static_cast<const uint8_t*>(data)},
+        m_data_size {data_size} {}
+
+    // true if the blob starts with a stream header; it may still be invalid
+    bool IsStream() const noexcept {
+        uint32_t message {0u};
+        if (m_data != nullptr && m_data_size >= sizeof(message)) {
+            std::memcpy(&message, m_data, sizeof(message));
+        }
+        return message == MessageStream::MessageStreamMessage;
+    }
+
+    // Checks the header and the framing of all records without applying any of them, so a corrupt stream is
+    // rejected as a whole
+    bool Validate() const noexcept {
+        if (!IsStream() || m_data_size < sizeof(MessageStream) || reinterpret_cast<uintptr_t>(m_data) % alignof(MessageStream) != 0u) {
+            return false;
+        }
+        const MessageStream* header = reinterpret_cast<const MessageStream*>(m_data);
+        if (header->major_version != MessageStream::MajorVersion || header->size > m_data_size - sizeof(MessageStream)) {
+            return false;
+        }
+        size_t offset = sizeof(MessageStream);
+        const size_t end = sizeof(MessageStream) + header->size;
+        for (uint32_t r = 0; r < header->record_count; ++r) {
+            if (end - offset < sizeof(MessageRecord)) {
+                return false;
+            }
+            const MessageRecord* record = reinterpret_cast<const MessageRecord*>(m_data + offset);
+            offset += sizeof(MessageRecord);
+            uint32_t payload_message {0u};
+            if (record->size < sizeof(payload_message) || end - offset < Padded(record->size)) {
+                return false;
+            }
+            std::memcpy(&payload_message, m_data + offset, sizeof(payload_message));
+            if (payload_message != record->message) {
+                return false;
+            }
+            offset += Padded(record->size);
+        }
+        return offset == end;
+    }
+
+    // calls `fn(const Record&)` for every record of a validated stream
+    template <class Fn>
+    void ForEach(Fn&& fn) const noexcept {
+        const MessageStream* header = reinterpret_cast<const MessageStream*>(m_data);
+        size_t offset = sizeof(MessageStream);
+        for (uint32_t r = 0; r < header->record_count; ++r) {
+            const MessageRecord* record = reinterpret_cast<const MessageRecord*>(m_data + offset);
+            offset += sizeof(MessageRecord);
+            fn(Record {record->message, m_data + offset, record->size});
+            offset += Padded(record->size);
+        }
+    }
+
+    static constexpr size_t Padded(size_t size) noexcept { return (size + 3u) & ~static_cast<size_t>(3u); }
+
+private:
+    const uint8_t* m_data;
+    size_t m_data_size;
+};
+
+// Writes a message stream into a caller provided, 4-byte aligned buffer, e.g., one that is reused for every launch.
+class MessageStreamWriter {
+public:
+    MessageStreamWriter(void* buffer, size_t capacity) noexcept :
+        m_buffer {static_cast<uint8_t*>(buffer)},
+        m_capacity {capacity} {
+        Clear();
+    }
+
+    // starts a new, empty stream
+    void Clear() noexcept {
+        m_size = 0u;
+        if (m_buffer != nullptr && m_capacity >= sizeof(MessageStream)) {
+            new (m_buffer) MessageStream {};
+            m_size = sizeof(MessageStream);
+        }
+    }
+
+    // appends a message (any struct with a `ThisMessage` member); false if it does not fit
+    template <class Message>
+    bool Append(const Message& message) noexcept {
+        static_assert(sizeof(Message) % 4u == 0u, "messages are padded to 4 bytes");
+        const size_t record_size = sizeof(MessageRecord) + sizeof(Message);
+        if (m_size == 0u || m_capacity - m_size < record_size) {
+            return false;
+        }
+        new (m_buffer + m_size) MessageRecord {message.ThisMessage, static_cast<uint32_t>(sizeof(Message))};
+        std::memcpy(m_buffer + m_size + sizeof(MessageRecord), &message, sizeof(Message));
+        m_size += record_size;
+
+        MessageStream* header = reinterpret_cast<MessageStream*>(m_buffer);
+        header->size = static_cast<uint32_t>(m_size - sizeof(MessageStream));
+        ++header->record_count;
+        return true;
+    }
+
+    const void* GetData() const noexcept { return m_buffer; }
+    // bytes to pass to SetData (or as LaunchData::app_data_size); 0 if the buffer can not hold a header
+    uint32_t GetSize() const noexcept { return static_cast<uint32_t>(m_size); }
+
+private:
+    uint8_t* m_buffer;
+    size_t m_capacity;
+    size_t m_size {0u};
+};
+
+} // namespace GainConfig
+
+#endif // GAIN_GAIN_MESSAGE_STREAM_H
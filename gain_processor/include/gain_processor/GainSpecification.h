@@ -8,22 +8,195 @@
 #define GAIN_GAIN_SPECIFICATION_H
 
 #include <cstdint>
+#include <cstring>
 #include <stddef.h>
 
 namespace GainConfig {
 
+// unit of Parameters::gain_value
+enum class GainUnit : uint32_t {
+    // linear factor
+    eLinear = 0,
+    // decibel; values <= -120 dB mute
+    eDecibel = 1,
+    // normalized fader position in [0, 1], mapped through the Specification::taper
+    eFader = 2
+};
+
+// curve that maps a fader position to a gain
+enum class FaderTaper : uint32_t {
+    // the position is the linear gain
+    eLinear = 0,
+    // the position is linear in dB between -60 dB and +6 dB; 0 mutes
+    eLogarithmic = 1,
+    // console-style fader scale with unity gain at 3/4 of the travel and +10 dB at the top
+    eAudio = 2
+};
+
+// processing of channel pairs (2k, 2k + 1), e.g., the left and right channel of stereo buses
+enum class PairMode : uint32_t {
+    // every channel is processed on its own
+    eNone = 0,
+    // mid/side gain, set with MidSideParameters
+    eMidSide = 1,
+    // balance or panning of the pair, set with BalanceParameters
+    eBalance = 2
+};
+
+// gains of the two channels of a pair over the balance position
+enum class PanLaw : uint32_t {
+    // balance control: unity in the center, the opposite channel fades out linearly
+    eBalance = 0,
+    // -3 dB in the center (sin/cos), constant power for uncorrelated channels
+    eConstantPower = 1,
+    // -4.5 dB in the center, between constant power and constant amplitude
+    eCompromise = 2
+};
+
+// nonlinear stage after the gain; the gain then acts as drive
+enum class Saturation : uint32_t {
+    eNone = 0,
+    // clamps to [-1, 1]
+    eHardClip = 1,
+    // cubic soft clipper: linear around zero, reaching 1 at an input of 1.5 with zero slope
+    eSoftClip = 2
+};
+
 struct Parameters {
     static constexpr uint32_t GainMessage = 0xDE2F52AD;
     uint32_t ThisMessage {GainMessage};
 
     float gain_value {};
+    GainUnit unit {GainUnit::eLinear};
+    // number of samples over which the gain moves from the current to the new value; 0 jumps immediately.
+    // Linear gains ramp linearly, decibel and fader gains ramp linearly in dB.
+    uint32_t ramp_length {};
+};
+
+// Message for GainProcessor::SetData of processors with PairMode::eMidSide. The pair is encoded to
+// mid = (left + right) / 2 and side = (left - right) / 2, the gains are applied and it is decoded again.
+// Changes are interpolated over one buffer. Parameters::gain still applies to both channels.
+struct MidSideParameters {
+    static constexpr uint32_t MidSideMessage = 0xDE2F52B0;
+    uint32_t ThisMessage {MidSideMessage};
+
+    float mid_gain {1.0f};
+    float side_gain {1.0f};
+    // unit of both gains
+    GainUnit unit {GainUnit::eLinear};
+};
+
+// Message for GainProcessor::SetData of processors with PairMode::eBalance. Changes are interpolated over one
+// buffer. Parameters::gain still applies to both channels.
+struct BalanceParameters {
+    static constexpr uint32_t BalanceMessage = 0xDE2F52B1;
+    uint32_t ThisMessage {BalanceMessage};
+
+    // -1 is hard left (channel 2k), 0 the center and 1 hard right (channel 2k + 1)
+    float balance {0.0f};
+    PanLaw law {PanLaw::eBalance};
 };
 
+// The specification is binary ABI between hosts and the processor: every member is a 32-bit integer, float or enum
+// (no bool, no nested structs), so its layout does not depend on the compiler and never changes when a message grows.
 struct Specification {
     static constexpr uint32_t GainConstructionType = 0xDE2F52AC;
     uint32_t ThisType {GainConstructionType};
 
-    Parameters params {};
+    // The initial gain. The first version embedded a Parameters message here, whose ThisMessage is kept in
+    // `params_message` and ignored.
+    uint32_t params_message {Parameters::GainMessage};
+    float gain_value {};
+    GainUnit gain_unit {GainUnit::eLinear};
+
+    // 1: flush subnormals to zero and replace NaN/Inf with zero. Adds a second output port (index 1)
+    // that receives the number of sanitized samples of each channel of the last buffer (one uint32_t per channel).
+    uint32_t sanitize {0u};
+
+    // taper used for GainUnit::eFader values
+    FaderTaper taper {FaderTaper::eAudio};
+
+    // 1: brickwall limiter after the gain, e.g., for bus outputs. Delays the output by `limiter_lookahead` samples and
+    // flushes NaN/Inf and subnormal input to zero (counted if `sanitize` is set as well). Adds an output port for the
+    // limiter's state on the device (after the counters, if any), 2 * `limiter_lookahead` floats per channel.
+    uint32_t limit {0u};
+    // maximum output magnitude in dBFS
+    float limiter_ceiling {-1.0f};
+    // look-ahead in samples, clamped to [1, 256]; 240 is 5 ms at 48 kHz
+    uint32_t limiter_lookahead {240u};
+    // number of samples in which the gain recovers from 20 dB of gain reduction; 4800 is 100 ms at 48 kHz
+    uint32_t limiter_release {4800u};
+
+    // processes channels in pairs; requires an even channel count and can not be combined with `sanitize` or `limit`
+    PairMode pair_mode {PairMode::eNone};
+
+    // saturates the gained signal. Can not be combined with `sanitize`, `limit` or `pair_mode`.
+    Saturation saturation {Saturation::eNone};
+    // 1, 2 or 4: runs the saturation at this multiple of the sample rate to keep the harmonics it creates from
+    // aliasing. Oversampling by 2 or 4 delays the output by 15 samples (see GainOversampler) and adds an output port
+    // (index 1) for the filter histories on the device.
+    uint32_t oversampling {1u};
+};
+
+// Messages and the specification only ever grow at their end. The processor accepts every version from the first
+// one on: members past the end of an older version keep their defaults, members appended by a newer one are ignored.
+// The first Parameters was {ThisMessage, gain_value}, a linear gain applied without ramp.
+constexpr size_t g_parameters_v1_size {2u * sizeof(uint32_t)};
+// The first Specification was {ThisType, params} with the first Parameters.
+constexpr size_t g_specification_v1_size {sizeof(uint32_t) + g_parameters_v1_size};
+
+// the members of the first Specification are where that version had them, and no member is ever inserted
+static_assert(offsetof(Specification, gain_value) == sizeof(uint32_t) + offsetof(Parameters, gain_value), "the first Specification embedded Parameters");
+static_assert(sizeof(Specification) == 13u * sizeof(uint32_t), "members of the Specification are only appended");
+
+// Reads `size` bytes written against any version of `T` from `min_size` bytes on into `value` (see above).
+template <class T>
+bool ReadVersioned(const void* data, size_t size, size_t min_size, T& value) noexcept {
+    if (data == nullptr || size < min_size) {
+        return false;
+    }
+    value = T {};
+    std::memcpy(&value, data, size < sizeof(T) ? size : sizeof(T));
+    return true;
+}
+
+// Query for GainProcessor::GetData. The processor fills in where the sanitize counters are produced; the host reads
+// them from the CPU copy of that output port after each launch. Hosts built against the first version pass the
+// first g_sanitize_info_v1_size bytes and get only those.
+struct SanitizeInfo {
+    static constexpr uint32_t SanitizeInfoMessage = 0xDE2F52AE;
+    uint32_t ThisMessage {SanitizeInfoMessage};
+
+    // 1 if the processor was created with `Specification::sanitize`
+    uint32_t enabled {};
+    // index of the output port holding the counters; the port is transferred to the CPU after each launch
+    uint32_t counter_port {};
+    // number of counters, i.e., the current channel count
+    uint32_t counter_count {};
+    // the counter of channel c is the uint32_t at byte offset c * counter_stride of the port's data
+    uint32_t counter_stride {};
+};
+
+constexpr uint32_t g_sanitize_info_v1_size {4u * sizeof(uint32_t)};
+
+// Query for GainProcessor::GetData. The processor fills in the statistics of the pool its module
+// creates all gain processors from.
+struct PoolInfo {
+    static constexpr uint32_t PoolInfoMessage = 0xDE2F52AF;
+    uint32_t ThisMessage {PoolInfoMessage};
+
+    // number of slabs the pool requested from the heap
+    uint32_t slab_count {};
+    // bytes per processor
+    uint32_t slot_size {};
+    // number of processors that fit into all slabs
+    uint32_t capacity {};
+    // number of live processors
+    uint32_t in_use {};
+    // highest number of live processors at once
+    uint32_t peak_in_use {};
+    // number of processors created over the lifetime of the module
+    uint64_t allocation_count {};
 };
 
 } // namespace GainConfig
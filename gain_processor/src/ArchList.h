@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_ARCH_LIST_H
+#define GAIN_ARCH_LIST_H
+
+#include <cstddef>
+#include <string_view>
+
+// Compile-time access to the list of GPU architectures the device code is built for.
+// The list comes from CMake as a colon separated string, e.g., CUDA_ARCHS="75:86" or HIP_ARCHS="gfx906:gfx1030".
+namespace gain {
+
+#if defined(GPU_AUDIO_NV)
+constexpr std::string_view g_arch_list {CUDA_ARCHS};
+#elif defined(GPU_AUDIO_AMD)
+constexpr std::string_view g_arch_list {HIP_ARCHS};
+#else
+constexpr std::string_view g_arch_list {"arm64"};
+#endif
+
+constexpr char g_arch_delimiter {':'};
+
+// number of entries of a colon separated list
+constexpr size_t ArchCount(std::string_view list) {
+    if (list.empty()) {
+        return 0u;
+    }
+    size_t count = 1u;
+    for (char c : list) {
+        count += c == g_arch_delimiter ? 1u : 0u;
+    }
+    return count;
+}
+
+// entry `index` of a colon separated list
+constexpr std::string_view ArchAt(std::string_view list, size_t index) {
+    size_t begin = 0u;
+    for (; index > 0u; --index) {
+        begin = list.find(g_arch_delimiter, begin) + 1u;
+    }
+    const size_t end = list.find(g_arch_delimiter, begin);
+    return list.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+}
+
+} // namespace gain
+
+#endif // GAIN_ARCH_LIST_H
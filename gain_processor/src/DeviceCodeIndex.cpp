@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "DeviceCodeIndex.h"
+
+#include <gain_processor/GainDeviceCode.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+constexpr char g_hex_digits[] {"0123456789abcdef"};
+
+// rejects files that can not be device code, e.g., a file truncated by a compiler that is about to rewrite it
+bool HasDeviceCodeHeader(const std::vector<char>& data) noexcept {
+    return data.size() > sizeof(g_device_code_magic) && std::memcmp(data.data(), g_device_code_magic, sizeof(g_device_code_magic)) == 0;
+}
+
+// the file as it is now if it still has the stamp it had before reading; nullptr otherwise, e.g., while the compiler
+// writes it (the next call tries again)
+std::shared_ptr<const DeviceCodeBlob> ReadFile(const std::filesystem::path& path, uintmax_t size, std::filesystem::file_time_type time) {
+    auto blob = std::make_shared<DeviceCodeBlob>();
+    blob->storage.reserve(static_cast<size_t>(size));
+    {
+        std::ifstream file {path, std::ios::binary};
+        if (!file) {
+            return nullptr;
+        }
+        blob->storage.assign(std::istreambuf_iterator<char> {file}, std::istreambuf_iterator<char> {});
+        if (file.bad()) {
+            return nullptr;
+        }
+    }
+    std::error_code error;
+    if (blob->storage.size() != size || std::filesystem::file_size(path, error) != size || error ||
+        std::filesystem::last_write_time(path, error) != time || error || !HasDeviceCodeHeader(blob->storage)) {
+        return nullptr;
+    }
+    blob->data = blob->storage.data();
+    blob->size = blob->storage.size();
+    blob->hash = GainConfig::HashDeviceCode(blob->data, blob->size);
+    blob->path = path.string();
+    return blob;
+}
+
+} // namespace
+
+void FormatDeviceCodeHash(uint64_t hash, char* digits) noexcept {
+    for (size_t i = g_device_code_hash_digits; i > 0u; --i, hash >>= 4u) {
+        digits[i - 1u] = g_hex_digits[hash & 0xFu];
+    }
+}
+
+bool ParseDeviceCodeHash(const char* begin, const char* end, uint64_t& hash) noexcept {
+    while (end != begin && (end[-1] == '\n' || end[-1] == '\r')) {
+        --end;
+    }
+    if (end - begin != static_cast<ptrdiff_t>(g_device_code_hash_digits)) {
+        return false;
+    }
+    uint64_t value = 0u;
+    for (; begin != end; ++begin) {
+        const char* digit = std::strchr(g_hex_digits, *begin);
+        if (*begin == '\0' || digit == nullptr) {
+            return false;
+        }
+        value = value << 4u | static_cast<uint64_t>(digit - g_hex_digits);
+    }
+    hash = value;
+    return true;
+}
+
+DeviceCodeIndex::DeviceCodeIndex(EmbeddedLookup embedded, const char* override_variable) noexcept :
+    m_embedded {embedded}, m_override_variable {override_variable} {
+}
+
+std::shared_ptr<const DeviceCodeBlob> DeviceCodeIndex::Find(const std::string& filename) {
+    std::lock_guard<std::mutex> lock {m_mutex};
+    Entry& entry = m_entries[filename];
+    if (auto blob = FindOverride(filename, entry)) {
+        return blob;
+    }
+
+    // embedded code; also if the override file disappeared or can not be read
+    if (!entry.blob || !entry.blob->path.empty()) {
+        const EmbeddedCode code = m_embedded(filename);
+        auto blob = std::make_shared<DeviceCodeBlob>();
+        blob->data = code.data;
+        blob->size = code.size;
+        blob->hash = code.hash;
+        entry = {std::move(blob), 0u, {}};
+    }
+    return entry.blob;
+}
+
+std::shared_ptr<const DeviceCodeBlob> DeviceCodeIndex::FindOverride(const std::string& filename, Entry& entry) const {
+    const char* override_dir = m_override_variable != nullptr ? std::getenv(m_override_variable) : nullptr;
+    if (override_dir == nullptr || override_dir[0] == '\0') {
+        return nullptr;
+    }
+    const std::filesystem::path path = std::filesystem::path {override_dir} / filename;
+    std::error_code error;
+    const auto size = std::filesystem::file_size(path, error);
+    const auto time = error ? std::filesystem::file_time_type {} : std::filesystem::last_write_time(path, error);
+    if (error) {
+        return nullptr;
+    }
+    const bool current = entry.blob && entry.blob->path == path.string();
+    if (current && entry.size == size && entry.time == time) {
+        return entry.blob;
+    }
+    if (auto blob = ReadFile(path, size, time)) {
+        entry = {std::move(blob), size, time};
+        return entry.blob;
+    }
+    // keep serving the previous version of the file until the new one can be read
+    return current ? entry.blob : nullptr;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_DEVICE_CODE_INDEX_H
+#define GAIN_DEVICE_CODE_INDEX_H
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// A device code binary, either embedded (`storage` empty, `data` points into the module binary) or read from the
+// override directory
+struct DeviceCodeBlob {
+    std::vector<char> storage;
+    const char* data {nullptr};
+    uint64_t size {0u};
+    // GainConfig::HashDeviceCode of the bytes; computed at build time for embedded code
+    uint64_t hash {0u};
+    // path of the override file; empty for embedded code
+    std::string path;
+};
+
+// The build writes the hash of every embedded binary as a resource next to it, named like the binary with this
+// suffix and holding the hash as 16 hex digits (see cmake/DeviceCodeHash.cmake)
+constexpr const char* g_device_code_hash_suffix {".fnv1a"};
+constexpr size_t g_device_code_hash_digits {16u};
+
+// CUDA cubins and AMD code objects are ELF files, Metal libraries start with "MTLB"
+#if defined(GPU_AUDIO_MAC)
+constexpr char g_device_code_magic[] {'M', 'T', 'L', 'B'};
+#else
+constexpr char g_device_code_magic[] {'\x7f', 'E', 'L', 'F'};
+#endif
+
+// the hash resource of a binary; `digits` holds g_device_code_hash_digits characters
+void FormatDeviceCodeHash(uint64_t hash, char* digits) noexcept;
+// false unless [begin, end) is a hash resource, optionally followed by a line break
+bool ParseDeviceCodeHash(const char* begin, const char* end, uint64_t& hash) noexcept;
+
+// Blobs by file name, shared by all providers of the module. Embedded code comes with its hash from the build, so
+// it is served without reading it. If the index has an override variable and the directory it names holds a file of
+// the requested name, that file is served instead; it is read and hashed again only when its size or modification
+// time changes, so unchanged device code keeps its hash and a rebuilt file is picked up by the next Find. Override
+// files must be replaced atomically (see GainConfig::g_device_code_dir_variable); as a safeguard against files
+// rewritten in place, a file is only taken if it did not change while it was read and starts with the header of the
+// platform's binaries. Until a new version can be read, the previous one is served.
+class DeviceCodeIndex {
+public:
+    struct EmbeddedCode {
+        const char* data;
+        uint64_t size;
+        uint64_t hash;
+    };
+    // the embedded binary of a file name; throws if there is none
+    using EmbeddedLookup = EmbeddedCode (*)(const std::string& filename);
+
+    // `override_variable`: environment variable naming the override directory; nullptr serves embedded code only
+    explicit DeviceCodeIndex(EmbeddedLookup embedded, const char* override_variable = nullptr) noexcept;
+
+    std::shared_ptr<const DeviceCodeBlob> Find(const std::string& filename);
+
+private:
+    struct Entry {
+        std::shared_ptr<const DeviceCodeBlob> blob;
+        // stamp of the override file the blob was read from
+        uintmax_t size {0u};
+        std::filesystem::file_time_type time {};
+    };
+
+    // the override file of `entry` if there is one that can be served, nullptr otherwise
+    std::shared_ptr<const DeviceCodeBlob> FindOverride(const std::string& filename, Entry& entry) const;
+
+    EmbeddedLookup m_embedded;
+    const char* m_override_variable;
+    std::mutex m_mutex;
+    std::map<std::string, Entry> m_entries;
+};
+
+#endif // GAIN_DEVICE_CODE_INDEX_H
@@ -8,9 +8,13 @@
 
 #include "cmrc/cmrc.hpp"
 
+#include <gain_processor/GainDeviceCode.h>
+
 #include <codecvt>
 #include <iostream>
+#include <iterator>
 #include <locale>
+#include <stdexcept>
 #include <string>
 
 CMRC_DECLARE(BG::gain_processor);
@@ -32,26 +36,51 @@ static const std::string g_gain_code_file_ext = ".o";
 static const std::string g_gain_code_file_ext = ".metallib";
 #endif
 
+// the override directory is only read by development builds
+#if defined(GAIN_DEVICE_CODE_OVERRIDE)
+constexpr const char* g_override_variable {GainConfig::g_device_code_dir_variable};
+#else
+constexpr const char* g_override_variable {nullptr};
+#endif
+
+// an embedded binary and the hash the build stored next to it
+DeviceCodeIndex::EmbeddedCode FindEmbeddedCode(const std::string& filename) {
+    auto fs = cmrc::BG::gain_processor::get_filesystem();
+    auto file = fs.open(filename);
+    auto hash_file = fs.open(filename + g_device_code_hash_suffix);
+    uint64_t hash;
+    if (!ParseDeviceCodeHash(hash_file.begin(), hash_file.end(), hash)) {
+        throw std::runtime_error("Error in FindEmbeddedCode: invalid hash resource of " + filename);
+    }
+    return {file.begin(), static_cast<uint64_t>(std::distance(file.begin(), file.end())), hash};
+}
+
+DeviceCodeIndex& GetDeviceCodeIndex() {
+    static DeviceCodeIndex index {FindEmbeddedCode, g_override_variable};
+    return index;
+}
+
 } // namespace
 
 GainDeviceCodeProvider::GainDeviceCodeProvider(const GPUA::processor::v2::DeviceCodeSpecification& specification) :
     m_platform {specification.platform} {
 }
 
-GPUA::processor::v2::ErrorCode GainDeviceCodeProvider::GetDeviceCode(GPUA::processor::v2::InputStream*& input_stream) noexcept {
+std::shared_ptr<const GainDeviceCodeProvider::Blob> GainDeviceCodeProvider::FindBlob() const {
     // convert gpu platform arch from wstring to string
     std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> converter;
     std::string platform_str = converter.to_bytes(m_platform);
 
     // assemble device code filename
-    std::string filename {g_gain_code_filename + platform_str + g_gain_code_file_ext};
+    return GetDeviceCodeIndex().Find(g_gain_code_filename + platform_str + g_gain_code_file_ext);
+}
 
+GPUA::processor::v2::ErrorCode GainDeviceCodeProvider::GetDeviceCode(GPUA::processor::v2::InputStream*& input_stream) noexcept {
     try {
         // read device code to binary stream
-        auto fs = cmrc::BG::gain_processor::get_filesystem();
-        auto file = fs.open(filename);
-        const auto size = std::distance(file.begin(), file.end());
-        m_stream = std::make_unique<StreamAdapter>(file.begin(), size);
+        auto blob = FindBlob();
+        m_stream = std::make_unique<StreamAdapter>(blob->data, blob->size);
+        m_blob = std::move(blob);
         input_stream = m_stream.get();
         return GPUA::processor::v2::ErrorCode::eSuccess;
     }
@@ -62,3 +91,14 @@ GPUA::processor::v2::ErrorCode GainDeviceCodeProvider::GetDeviceCode(GPUA::proce
     input_stream = nullptr;
     return GPUA::processor::v2::ErrorCode::eFail;
 }
+
+GPUA::processor::v2::ErrorCode GainDeviceCodeProvider::GetDeviceCodeHash(uint64_t& hash) noexcept {
+    try {
+        hash = FindBlob()->hash;
+        return GPUA::processor::v2::ErrorCode::eSuccess;
+    }
+    catch (const std::exception& exc) {
+        std::cout << exc.what() << std::endl;
+    }
+    return GPUA::processor::v2::ErrorCode::eFail;
+}
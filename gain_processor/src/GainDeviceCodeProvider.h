@@ -7,6 +7,8 @@
 #ifndef GAIN_GAIN_DEVICE_CODE_PROVIDER_H
 #define GAIN_GAIN_DEVICE_CODE_PROVIDER_H
 
+#include "DeviceCodeIndex.h"
+
 #include <os_utilities/IMemStream.h>
 #include <processor_api/DeviceCodeProvider.h>
 #include <processor_api/DeviceCodeSpecification.h>
@@ -27,6 +29,11 @@ public:
     // GPUA::processor::v2::DeviceCodeProvider method
     GPUA::processor::v2::ErrorCode GetDeviceCode(GPUA::processor::v2::InputStream*& input_stream) noexcept override;
 
+    // content hash (GainConfig::HashDeviceCode) of the blob GetDeviceCode would provide
+    GPUA::processor::v2::ErrorCode GetDeviceCodeHash(uint64_t& hash) noexcept;
+
+    using Blob = DeviceCodeBlob;
+
 private:
     class StreamAdapter : public GPUA::processor::v2::InputStream {
         IMemStream m_stream;
@@ -44,6 +51,12 @@ private:
             return GPUA::processor::v2::ErrorCode::eSuccess;
         }
     };
+
+    // the current blob for the platform, from the process-wide index
+    std::shared_ptr<const Blob> FindBlob() const;
+
+    // keeps the blob of the stream alive, even if the index replaces it with a newer override file
+    std::shared_ptr<const Blob> m_blob;
     std::unique_ptr<StreamAdapter> m_stream = nullptr;
     std::wstring m_platform;
 };
@@ -5,11 +5,17 @@
  */
 
 #include "GainInputPort.h"
+#include "Trace.h"
 
 #include <processor_api/PortDescription.h>
 
-GainInputPort::GainInputPort(GPUA::processor::v2::OutputPort* output_port) :
-    m_output_port {output_port} {
+GainInputPort::GainInputPort(GPUA::processor::v2::OutputPort* output_port, GPUA::processor::v2::OutputPort* counter_port,
+    GPUA::processor::v2::OutputPort* state_port, uint32_t state_size, uint32_t channel_multiple) :
+    m_output_port {output_port},
+    m_counter_port {counter_port},
+    m_state_port {state_port},
+    m_state_size {state_size},
+    m_channel_multiple {channel_multiple} {
 }
 
 GPUA::processor::v2::PortId GainInputPort::GetPortId() noexcept {
@@ -18,13 +24,13 @@ GPUA::processor::v2::PortId GainInputPort::GetPortId() noexcept {
 
 GPUA::processor::v2::ErrorCode GainInputPort::Connect(const GPUA::processor::v2::OutputPort& data_port) noexcept {
     using namespace GPUA::processor::v2;
+    GAIN_TRACE_SCOPE("GainInputPort::Connect");
 
     // get info of port that wants to connect to `this`
     auto& input_port = data_port.GetPortInfo();
 
     // make sure the port is compatible and can be connected
-    if (input_port.type != PortType::eRegularPort ||
-        input_port.data_type != PortDataType::eSample32) {
+    if (!IsSupported(data_port)) {
         return ErrorCode::eUnsupported;
     }
 
@@ -42,6 +48,9 @@ GPUA::processor::v2::ErrorCode GainInputPort::Connect(const GPUA::processor::v2:
 
     // signal the output port to reset with the new properties
     m_output_port->Changed(PortChangedFlags::eReset);
+    UpdateCounterPort();
+    UpdateStatePort();
+    m_state_reset = true;
 
     // indicate that the change to trigger a re-build of the blueprint
     // before the next launch (see GainProcessor::PrepareForProcess)
@@ -52,6 +61,7 @@ GPUA::processor::v2::ErrorCode GainInputPort::Connect(const GPUA::processor::v2:
 
 GPUA::processor::v2::ErrorCode GainInputPort::Disconnect() noexcept {
     using namespace GPUA::processor::v2;
+    GAIN_TRACE_SCOPE("GainInputPort::Disconnect");
 
     // clear properties
     m_max_buffer_size = m_current_buffer_size = 0;
@@ -70,17 +80,20 @@ GPUA::processor::v2::ErrorCode GainInputPort::Disconnect() noexcept {
 
     // signal the output port to reset with the cleared properties
     m_output_port->Changed(PortChangedFlags::eReset);
+    UpdateCounterPort();
+    UpdateStatePort();
+    m_state_reset = true;
 
     return ErrorCode::eSuccess;
 }
 
 GPUA::processor::v2::ErrorCode GainInputPort::InputPortUpdated(GPUA::processor::v2::PortChangedFlags flags, const GPUA::processor::v2::OutputPort& data_port) noexcept {
     using namespace GPUA::processor::v2;
+    GAIN_TRACE_SCOPE("GainInputPort::InputPortUpdated");
 
     // make sure the update is supported
     auto& input_port = data_port.GetPortInfo();
-    if (input_port.type != PortType::eRegularPort ||
-        input_port.data_type != PortDataType::eSample32) {
+    if (!IsSupported(data_port)) {
         Disconnect();
         return ErrorCode::eUnsupported;
     }
@@ -112,9 +125,70 @@ GPUA::processor::v2::ErrorCode GainInputPort::InputPortUpdated(GPUA::processor::
     else {
         m_output_port->Changed(new_flags);
     }
+    if (flags == PortChangedFlags::eReset || (flags % PortChangedFlags::eChannelCountChanged)) {
+        UpdateCounterPort();
+        UpdateStatePort();
+        m_state_reset = true;
+    }
     return ErrorCode::eSuccess;
 }
 
+bool GainInputPort::IsSupported(const GPUA::processor::v2::OutputPort& data_port) const noexcept {
+    using namespace GPUA::processor::v2;
+
+    auto& input_port = data_port.GetPortInfo();
+    return input_port.type == PortType::eRegularPort &&
+        input_port.data_type == PortDataType::eSample32 &&
+        input_port.channel_count % m_channel_multiple == 0u;
+}
+
+void GainInputPort::UpdateCounterPort() noexcept {
+    using namespace GPUA::processor::v2;
+
+    if (!m_counter_port) {
+        return;
+    }
+
+    // one uint32_t counter per channel; the counters are read on the host, so transfer them to the CPU
+    auto& counter_port = m_counter_port->GetPortInfo();
+    counter_port.type = PortType::eRegularPort;
+    counter_port.data_type = PortDataType::eSample32;
+    counter_port.channel_count = m_channel_count;
+    counter_port.capacity_in_bytes = sizeof(uint32_t);
+    counter_port.size_in_bytes = sizeof(uint32_t);
+    counter_port.grain = counter_port.capacity_in_bytes;
+    counter_port.offset = 0;
+    counter_port.oversampling_ratio = 0;
+    counter_port.is_produced = m_channel_count != 0;
+    counter_port.transfer_to_cpu = m_channel_count != 0;
+
+    m_counter_port->Changed(PortChangedFlags::eReset);
+}
+
+void GainInputPort::UpdateStatePort() noexcept {
+    using namespace GPUA::processor::v2;
+
+    if (!m_state_port) {
+        return;
+    }
+
+    // `m_state_size` floats per channel that only the device reads and writes. The port is only reset together with
+    // the state (see m_state_reset); in between, the task finds what it wrote in the previous launch
+    auto& state_port = m_state_port->GetPortInfo();
+    state_port.type = PortType::eRegularPort;
+    state_port.data_type = PortDataType::eSample32;
+    state_port.channel_count = m_channel_count;
+    state_port.capacity_in_bytes = m_state_size * sizeof(float);
+    state_port.size_in_bytes = state_port.capacity_in_bytes;
+    state_port.grain = state_port.capacity_in_bytes;
+    state_port.offset = 0;
+    state_port.oversampling_ratio = 0;
+    state_port.is_produced = m_channel_count != 0;
+    state_port.transfer_to_cpu = false;
+
+    m_state_port->Changed(PortChangedFlags::eReset);
+}
+
 uint32_t GainInputPort::GetInputGrain() const noexcept {
     return m_max_buffer_size * sizeof(float);
 }
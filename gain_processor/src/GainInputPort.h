@@ -10,9 +10,15 @@
 #include <processor_api/InputPort.h>
 #include <processor_api/OutputPort.h>
 
+#include <cstdint>
+
 class GainInputPort : public GPUA::processor::v2::InputPort {
 public:
-    explicit GainInputPort(GPUA::processor::v2::OutputPort* output_port);
+    // `counter_port` is the optional output port for the sanitize counters (nullptr if sanitizing is off) and
+    // `state_port` the optional output port for `state_size` floats of device state per channel (nullptr for the
+    // stateless tasks). Connections with a channel count that is not a multiple of `channel_multiple` are rejected.
+    explicit GainInputPort(GPUA::processor::v2::OutputPort* output_port, GPUA::processor::v2::OutputPort* counter_port = nullptr,
+        GPUA::processor::v2::OutputPort* state_port = nullptr, uint32_t state_size = 0u, uint32_t channel_multiple = 1u);
     ~GainInputPort() = default;
 
     // Copy ctor and copy assignment are deleted along with move assignment operator deletion
@@ -37,9 +43,24 @@ public:
     uint32_t m_max_buffer_size {};
 
     bool m_changed {false};
+    // set when the channels of the connection may have changed meaning (connect, disconnect, reset, channel count
+    // change); the processor then asks the device to reset its per-channel state (see gain::ProcessorParameter::reset_state)
+    bool m_state_reset {true};
 
 private:
+    // true if the processor can process the output of `data_port`
+    bool IsSupported(const GPUA::processor::v2::OutputPort& data_port) const noexcept;
+
+    // configures the counter port for one counter per channel
+    void UpdateCounterPort() noexcept;
+    // configures the state port for the state of every channel
+    void UpdateStatePort() noexcept;
+
     GPUA::processor::v2::OutputPort* m_output_port;
+    GPUA::processor::v2::OutputPort* m_counter_port;
+    GPUA::processor::v2::OutputPort* m_state_port;
+    uint32_t m_state_size;
+    uint32_t m_channel_multiple;
 };
 
 #endif // GAIN_GAIN_INPUT_PORT_H
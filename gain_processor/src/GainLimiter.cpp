@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "GainLimiter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// log2 of the gain per dB
+constexpr float g_log2_per_decibel {0.166096404744368f};
+// gain reduction that `Specification::limiter_release` refers to
+constexpr float g_release_reference_decibel {20.0f};
+} // namespace
+
+GainLimiter::GainLimiter(const GainConfig::Specification& specification) noexcept :
+    m_ceiling {std::isfinite(specification.limiter_ceiling) ? specification.limiter_ceiling * g_log2_per_decibel : 0.0f},
+    m_release_step {g_release_reference_decibel * g_log2_per_decibel / static_cast<float>(std::max(specification.limiter_release, 1u))},
+    m_lookahead {std::clamp(specification.limiter_lookahead, 1u, gain::g_limiter_max_lookahead)} {
+}
+
+void GainLimiter::Apply(gain::ProcessorParameter& params, bool count_sanitized) const noexcept {
+    params.limiter_ceiling = m_ceiling;
+    params.limiter_release_step = m_release_step;
+    params.limiter_lookahead = m_lookahead;
+    params.limiter_count_sanitized = count_sanitized ? 1u : 0u;
+}
+
+uint32_t GainLimiter::GetSharedMemorySize(uint32_t thread_count) const noexcept {
+    // signal, two work arrays and the envelope hold a tile plus the look-ahead, the window one value per thread
+    return (4u * (thread_count + m_lookahead) + thread_count) * static_cast<uint32_t>(sizeof(float));
+}
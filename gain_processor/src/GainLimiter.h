@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_GAIN_LIMITER_H
+#define GAIN_GAIN_LIMITER_H
+
+#include "Properties.h"
+
+#include <gain_processor/GainSpecification.h>
+
+#include <cstdint>
+
+// Host-side settings of the device limiter (see GainProcessorDevice::process_limited), converted from the
+// units of GainConfig::Specification to the ones of gain::ProcessorParameter.
+class GainLimiter {
+public:
+    explicit GainLimiter(const GainConfig::Specification& specification) noexcept;
+
+    // write the limiter settings to the processor parameter; `count_sanitized` enables the sanitize counters
+    void Apply(gain::ProcessorParameter& params, bool count_sanitized) const noexcept;
+
+    // bytes of shared memory process_limited needs for blocks of `thread_count` threads
+    uint32_t GetSharedMemorySize(uint32_t thread_count) const noexcept;
+    // floats of state process_limited keeps per channel: the delay line and the envelope of the look-ahead
+    uint32_t GetStateSize() const noexcept { return 2u * m_lookahead; }
+
+    uint32_t GetLookahead() const noexcept { return m_lookahead; }
+
+private:
+    float m_ceiling;
+    float m_release_step;
+    uint32_t m_lookahead;
+};
+
+#endif // GAIN_GAIN_LIMITER_H
@@ -5,26 +5,50 @@
  */
 
 #include "GainModule.h"
-#include "GainProcessor.h"
+#include "Trace.h"
 
 GainModule::GainModule(const GPUA::processor::v2::ModuleSpecification& specification) :
-    GPUA::processor::v2::ModuleBase(specification) {}
+    GPUA::processor::v2::ModuleBase(specification) {
+    // the trace (if compiled in, see Trace.h) covers the lifetime of the module
+    GAIN_TRACE_BEGIN_SESSION();
+}
+
+GainModule::~GainModule() {
+    GAIN_TRACE_END_SESSION();
+}
 
 GPUA::processor::v2::ErrorCode GainModule::CreateProcessor(GPUA::processor::v2::ProcessorSpecification& specification, GPUA::processor::v2::Processor*& processor) noexcept {
-    try {
-        processor = new GainProcessor(specification, *this);
-        return GPUA::processor::v2::ErrorCode::eSuccess;
+    GAIN_TRACE_SCOPE("GainModule::CreateProcessor");
+    processor = nullptr;
+    void* memory = m_processor_pool.Allocate();
+    if (memory == nullptr) {
+        return GPUA::processor::v2::ErrorCode::eFail;
     }
-    catch (...) {
+    GainProcessor* gain_processor {nullptr};
+    const GPUA::processor::v2::ErrorCode result = GainProcessor::Create(specification, *this, memory, gain_processor);
+    if (result != GPUA::processor::v2::ErrorCode::eSuccess) {
+        m_processor_pool.Deallocate(memory);
+        return result;
     }
-    processor = nullptr;
-    return GPUA::processor::v2::ErrorCode::eFail;
+    processor = gain_processor;
+    return GPUA::processor::v2::ErrorCode::eSuccess;
 }
 
 GPUA::processor::v2::ErrorCode GainModule::DeleteProcessor(GPUA::processor::v2::Processor* processor) noexcept {
-    if (processor) {
-        delete processor;
-        return GPUA::processor::v2::ErrorCode::eSuccess;
-    }
-    return GPUA::processor::v2::ErrorCode::eFail;
+    GAIN_TRACE_SCOPE("GainModule::DeleteProcessor");
+    // only live processors created by this module are deleted, so deleting a processor twice fails the second time
+    // (GainProcessor derives from Processor only, so the pointers are the same). The pool looks the slot up once
+    const bool deleted = processor != nullptr &&
+        m_processor_pool.Destroy(processor, [](GainProcessor* gain_processor) { gain_processor->~GainProcessor(); });
+    return deleted ? GPUA::processor::v2::ErrorCode::eSuccess : GPUA::processor::v2::ErrorCode::eFail;
+}
+
+void GainModule::GetPoolInfo(GainConfig::PoolInfo& info) const noexcept {
+    const auto stats = m_processor_pool.GetStats();
+    info.slab_count = stats.slab_count;
+    info.slot_size = static_cast<uint32_t>(sizeof(GainProcessor));
+    info.capacity = stats.capacity;
+    info.in_use = stats.in_use;
+    info.peak_in_use = stats.peak_in_use;
+    info.allocation_count = stats.allocation_count;
 }
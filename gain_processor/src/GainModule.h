@@ -7,6 +7,11 @@
 #ifndef GAIN_GAIN_MODULE_H
 #define GAIN_GAIN_MODULE_H
 
+#include "GainProcessor.h"
+#include "SlabPool.h"
+
+#include <gain_processor/GainSpecification.h>
+
 #include <processor_api/ModuleBase.h>
 #include <processor_api/ModuleInfoProvider.h>
 #include <processor_api/ModuleSpecification.h>
@@ -14,7 +19,7 @@
 class GainModule : public GPUA::processor::v2::ModuleBase {
 public:
     explicit GainModule(const GPUA::processor::v2::ModuleSpecification& specification);
-    ~GainModule() override = default;
+    ~GainModule() override;
 
     // Copy ctor and copy assignment are deleted along with move assignment operator deletion
     GainModule& operator=(GainModule&&) = delete;
@@ -25,6 +30,16 @@ public:
     GPUA::processor::v2::ErrorCode DeleteProcessor(GPUA::processor::v2::Processor* processor) noexcept override;
     // GPUA::processor::v2::Module methods
     ////////////////////////////////
+
+    // statistics of the processor pool (see GainConfig::PoolInfo)
+    void GetPoolInfo(GainConfig::PoolInfo& info) const noexcept;
+
+private:
+    // processors per slab of the pool; sessions typically hold dozens to thousands of gain processors
+    static constexpr uint32_t ProcessorsPerSlab {64u};
+
+    // storage of all processors of the module; the input port of each processor lives inline in it
+    SlabPool<GainProcessor, ProcessorsPerSlab> m_processor_pool;
 };
 
 #endif // GAIN_GAIN_MODULE_H
@@ -6,18 +6,16 @@
 
 #include "GainModuleInfoProvider.h"
 
+#include "ArchList.h"
 #include "cuda/Properties.h"
 
 #include <processor_api/DeviceCodeSpecification.h>
 #include <processor_api/PlatformInfo.h>
 
-#include <algorithm>
 #include <array>
-#include <codecvt>
-#include <locale>
-#include <regex>
-
-#include <iostream>
+#include <cstddef>
+#include <string_view>
+#include <utility>
 
 #define Q(x) #x
 #define QQ(x) Q(x)
@@ -25,65 +23,110 @@
 
 #define QUOTEW(x) (L"" QUOTE(x))
 
+// The platform and entry name tables are built at compile time, so loading the module and querying its
+// platforms costs no allocations, regex parsing or locale conversions.
 namespace {
 
-std::vector<GPUA::processor::v2::PlatformInfo> ConstructSpecification(const std::vector<std::wstring>& archs_list) {
-    std::vector<GPUA::processor::v2::PlatformInfo> result;
-    std::transform(archs_list.begin(), archs_list.end(), std::back_inserter(result), [](auto& str) {
-        return GPUA::processor::v2::PlatformInfo {str.c_str()};
-    });
-    return result;
+// platform names are the entries of the CMake arch list (see ArchList.h); NVIDIA platforms get the "sm_" prefix
+#if defined(GPU_AUDIO_NV)
+constexpr std::string_view g_platform_prefix {"sm_"};
+#else
+constexpr std::string_view g_platform_prefix {""};
+#endif
+
+// longest platform name including the terminating zero
+constexpr size_t g_max_platform_name_length {32u};
+
+using PlatformName = std::array<wchar_t, g_max_platform_name_length>;
+
+constexpr bool PlatformNamesFit(std::string_view list) {
+    for (size_t i = 0; i < gain::ArchCount(list); ++i) {
+        if (g_platform_prefix.size() + gain::ArchAt(list, i).size() >= g_max_platform_name_length) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(gain::ArchCount(gain::g_arch_list) > 0u, "the arch list must not be empty");
+static_assert(PlatformNamesFit(gain::g_arch_list), "increase g_max_platform_name_length");
+
+// arch names are plain ASCII, so widening each character is the exact conversion
+constexpr PlatformName MakePlatformName(std::string_view arch) {
+    PlatformName name {};
+    size_t length = 0u;
+    for (char c : g_platform_prefix) {
+        name[length++] = static_cast<wchar_t>(c);
+    }
+    for (char c : arch) {
+        name[length++] = static_cast<wchar_t>(c);
+    }
+    return name;
 }
 
-std::vector<std::string> Split(const std::string& str, const std::string& delimiter) {
-    std::vector<std::string> result;
-    const std::regex regex(delimiter);
-    std::copy(std::sregex_token_iterator(str.begin(), str.end(), regex, -1), std::sregex_token_iterator(), std::back_inserter(result));
-    return result;
+template <size_t... Indices>
+constexpr std::array<PlatformName, sizeof...(Indices)> MakePlatformNames(std::index_sequence<Indices...>) {
+    return {{MakePlatformName(gain::ArchAt(gain::g_arch_list, Indices))...}};
 }
 
-std::vector<std::wstring> GetSupportedArchs() {
-    using convert_type = std::codecvt_utf8<wchar_t>;
-    std::wstring_convert<convert_type, wchar_t> converter;
+constexpr size_t g_platform_count {gain::ArchCount(gain::g_arch_list)};
 
-#if !defined(GPU_AUDIO_MAC)
-#if defined(GPU_AUDIO_NV)
-    std::vector<std::string> archs = Split(CUDA_ARCHS, ":");
-    std::vector<std::wstring> result;
-    std::transform(archs.begin(), archs.end(), std::back_inserter(result), [&](auto str) { return converter.from_bytes("sm_" + str); });
-    return result;
-#elif defined(GPU_AUDIO_AMD)
-    std::vector<std::string> archs = Split(HIP_ARCHS, ":");
-    std::vector<std::wstring> result;
-    std::transform(archs.begin(), archs.end(), std::back_inserter(result), [&](auto str) { return converter.from_bytes(str); });
-    return result;
-#endif
-#else
-    std::vector<std::string> archs = Split("arm64", ":");
-    std::vector<std::wstring> result;
-    std::transform(archs.begin(), archs.end(), std::back_inserter(result), [&](auto str) { return converter.from_bytes(str); });
-    return result;
-#endif
+constexpr std::array<PlatformName, g_platform_count> g_platform_names {MakePlatformNames(std::make_index_sequence<g_platform_count> {})};
+
+template <size_t... Indices>
+constexpr std::array<GPUA::processor::v2::PlatformInfo, sizeof...(Indices)> MakePlatformInfos(std::index_sequence<Indices...>) {
+    return {{GPUA::processor::v2::PlatformInfo {g_platform_names[Indices].data()}...}};
 }
+
+constexpr std::array<GPUA::processor::v2::PlatformInfo, g_platform_count> g_platform_infos {MakePlatformInfos(std::make_index_sequence<g_platform_count> {})};
+
+// three mandatory processor device functions. DO NOT MODIFY THE NEXT THREE LINES!
+constexpr const wchar_t* g_declare_processor {QUOTEW(SEL(0))};
+constexpr const wchar_t* g_init_processor {QUOTEW(SEL(1))};
+constexpr const wchar_t* g_destroy_processor {QUOTEW(SEL(2))};
+
+// Set the number of GPU tasks of the processor (see GainProcessor.cu). Gain has five: `process`,
+// `process_sanitized`, `process_limited`, `process_pair` and `process_saturated`; the host processor selects one of them via GpuTaskData::entry_idx
+constexpr uint32_t g_task_cnt {5u};
+
+////////////////
+// Set up processor GPU task names. Required for the engine to call the processor.
+
+// The SEL macro accesses GPUFUNCTIONS_SCRAMBLED (see Properties.h). Make sure
+// it has enough entries for the number of tasks (3 + 2 * task_cnt)
+// Add two entries for each additional processor task.
+constexpr std::array<const wchar_t*, 2 * g_task_cnt> g_task_names {
+    QUOTEW(SEL(3)),
+    QUOTEW(SEL(4)),
+    QUOTEW(SEL(5)),
+    QUOTEW(SEL(6)),
+    QUOTEW(SEL(7)),
+    QUOTEW(SEL(8)),
+    QUOTEW(SEL(9)),
+    QUOTEW(SEL(10)),
+    QUOTEW(SEL(11)),
+    QUOTEW(SEL(12))};
+//
+////////////////
+
+constexpr GPUA::processor::v2::ProcessorEntryInfo g_entry_info {
+    g_declare_processor,
+    g_destroy_processor,
+    g_init_processor,
+    g_task_cnt, g_task_names.data()};
+
 } // namespace
 
 GainModuleInfoProvider::GainModuleInfoProvider() {
 }
 
-const std::vector<GPUA::processor::v2::PlatformInfo>& GainModuleInfoProvider::GetCodeSpecs() {
-    static std::vector<std::wstring> supported_archs = GetSupportedArchs();
-    static std::vector<GPUA::processor::v2::PlatformInfo> supported_specs = ConstructSpecification(supported_archs);
-    return supported_specs;
-}
-
 uint32_t GainModuleInfoProvider::GetSupportPlatformCount() const noexcept {
-    return static_cast<uint32_t>(GetCodeSpecs().size());
+    return static_cast<uint32_t>(g_platform_infos.size());
 }
 
 GPUA::processor::v2::ErrorCode GainModuleInfoProvider::GetSupportPlatformInfo(uint32_t index, const GPUA::processor::v2::PlatformInfo*& platform_info) const noexcept {
-    auto& specs = GetCodeSpecs();
-    if (index < specs.size()) {
-        platform_info = &specs[index];
+    if (index < g_platform_infos.size()) {
+        platform_info = &g_platform_infos[index];
         return GPUA::processor::v2::ErrorCode::eSuccess;
     }
     platform_info = nullptr;
@@ -96,38 +139,6 @@ GPUA::processor::v2::ErrorCode GainModuleInfoProvider::GetModuleInfo(const GPUA:
 }
 
 GPUA::processor::v2::ErrorCode GainModuleInfoProvider::GetProcessorExecutionInfo(const GPUA::processor::v2::ProcessorEntryInfo*& entry_info) const noexcept {
-    // three mandatory processor device functions. DO NOT MODIFY NEXT THE THREE LINES!
-    static std::wstring declare_processor = std::wstring(QUOTEW(SEL(0)));
-    static std::wstring init_processor = std::wstring(QUOTEW(SEL(1)));
-    static std::wstring destroy_processor = std::wstring(QUOTEW(SEL(2)));
-
-    // Set the number of GPU tasks of the processor. Gain has only one (see GainProcessor.cu)
-    static constexpr uint32_t task_cnt = 1;
-
-    ////////////////
-    // Set up processor GPU task names. Required for the engine to call the processor.
-
-    // The SEL macro accesses GPUFUNCTIONS_SCRAMBLED (see Properties.h). Make sure
-    // it has enough entries for the number of tasks (3 + 2 * task_cnt)
-    // Add two entries for each additional processor task.
-    static std::array<std::wstring, 2 * task_cnt> task_names = {
-        QUOTEW(SEL(3)),
-        QUOTEW(SEL(4))};
-
-    // convert task names form wstring to const wchar_t*
-    // Add two entries for each additional processor task.
-    static std::array<const wchar_t*, 2 * task_cnt> task_names_p = {
-        task_names[0].c_str(),
-        task_names[1].c_str()};
-    //
-    ////////////////
-
-    static GPUA::processor::v2::ProcessorEntryInfo info {
-        declare_processor.c_str(),
-        destroy_processor.c_str(),
-        init_processor.c_str(),
-        task_cnt, task_names_p.data()};
-
-    entry_info = &info;
+    entry_info = &g_entry_info;
     return GPUA::processor::v2::ErrorCode::eSuccess;
 }
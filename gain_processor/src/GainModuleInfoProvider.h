@@ -10,8 +10,6 @@
 #include <processor_api/ModuleBase.h>
 #include <processor_api/ModuleInfoProvider.h>
 
-#include <vector>
-
 class GainModuleInfoProvider : public GPUA::processor::v2::ModuleInfoProvider {
 public:
     GainModuleInfoProvider();
@@ -30,8 +28,6 @@ public:
     ////////////////////////////////
 
 private:
-    static const std::vector<GPUA::processor::v2::PlatformInfo>& GetCodeSpecs();
-
     static constexpr const wchar_t* EffectName {L"" MODULE_EFFECT_NAME};
     static constexpr const wchar_t* ModuleId {L"" MODULE_ID};
     static constexpr const GPUA::processor::v2::Version Version {MODULE_MAJOR_VERSION, MODULE_MINOR_VERSION, MODULE_PATCH_LEVEL};
@@ -79,4 +79,15 @@ MODULE_EXPORT GPUA::processor::v2::ErrorCode DeleteDeviceCodeProvider_v2(GPUA::p
     return GPUA::processor::v2::ErrorCode::eFail;
 }
 
+// see GainConfig::HashDeviceCode
+MODULE_EXPORT GPUA::processor::v2::ErrorCode GetDeviceCodeHash_v2(const GPUA::processor::v2::DeviceCodeSpecification& specification, uint64_t& hash) {
+    try {
+        GainDeviceCodeProvider code_provider {specification};
+        return code_provider.GetDeviceCodeHash(hash);
+    }
+    catch (...) {
+    }
+    return GPUA::processor::v2::ErrorCode::eFail;
+}
+
 } // extern "C"
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "GainOversampler.h"
+
+GainOversampler::GainOversampler(const GainConfig::Specification& specification) noexcept :
+    m_saturation {specification.saturation},
+    m_ratio {specification.oversampling == 2u || specification.oversampling == 4u ? specification.oversampling : 1u},
+    m_taps_per_phase {m_ratio > 1u ? gain::g_oversampling_taps_per_phase : 1u} {
+}
+
+void GainOversampler::Apply(gain::ProcessorParameter& params) const noexcept {
+    params.saturation = static_cast<uint32_t>(m_saturation);
+    params.oversampling_ratio = m_ratio;
+    params.oversampling_taps_per_phase = m_taps_per_phase;
+}
+
+uint32_t GainOversampler::GetSharedMemorySize(uint32_t thread_count) const noexcept {
+    // the taps, the input tile with the interpolator's history, the oversampled tile with the decimator's history,
+    // and the staging area for carrying the histories over to the next tile
+    const uint32_t taps = m_ratio * m_taps_per_phase;
+    const uint32_t floats = taps + (m_taps_per_phase - 1u + thread_count) + (taps - 1u + m_ratio * thread_count) + (taps - 1u);
+    return floats * static_cast<uint32_t>(sizeof(float));
+}
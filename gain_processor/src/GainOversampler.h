@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_GAIN_OVERSAMPLER_H
+#define GAIN_GAIN_OVERSAMPLER_H
+
+#include "Properties.h"
+
+#include <gain_processor/GainSpecification.h>
+
+#include <cstdint>
+
+// Host-side settings of the saturation task (see GainProcessorDevice::process_saturated): the oversampling ratio
+// and the length of the polyphase lowpass that interpolates before and decimates after the nonlinearity.
+//
+// The lowpass has R * (P - 1) + 1 taps at the oversampled rate (R: ratio, P: taps per polyphase branch), zero-padded
+// to R * P taps; its taps are a table in the device code (gain::OversamplingTap). Both filters are linear phase, so
+// together they delay the signal by R * (P - 1) oversampled samples, i.e., P - 1 samples. Without oversampling the
+// filter is a single unit tap.
+class GainOversampler {
+public:
+    explicit GainOversampler(const GainConfig::Specification& specification) noexcept;
+
+    // write the saturation settings to the processor parameter
+    void Apply(gain::ProcessorParameter& params) const noexcept;
+
+    // bytes of shared memory process_saturated needs for blocks of `thread_count` threads
+    uint32_t GetSharedMemorySize(uint32_t thread_count) const noexcept;
+    // floats of state process_saturated keeps per channel: the P - 1 input samples of the interpolator and the
+    // R * P - 1 oversampled samples of the decimator; none without oversampling
+    uint32_t GetStateSize() const noexcept { return m_taps_per_phase - 1u + m_ratio * m_taps_per_phase - 1u; }
+
+    uint32_t GetRatio() const noexcept { return m_ratio; }
+    // output delay in samples
+    uint32_t GetLatency() const noexcept { return m_taps_per_phase - 1u; }
+
+private:
+    GainConfig::Saturation m_saturation;
+    uint32_t m_ratio;
+    uint32_t m_taps_per_phase;
+};
+
+#endif // GAIN_GAIN_OVERSAMPLER_H
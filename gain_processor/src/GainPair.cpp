@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "GainPair.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr float g_half_pi {1.57079632679f};
+constexpr GainPair::Matrix g_identity {1.0f, 0.0f, 0.0f, 1.0f};
+} // namespace
+
+GainPair::GainPair() noexcept :
+    m_current {g_identity},
+    m_target {g_identity} {
+}
+
+void GainPair::SetMidSide(float mid_gain, float side_gain) noexcept {
+    m_target = MidSideMatrix(mid_gain, side_gain);
+}
+
+void GainPair::SetBalance(float balance, GainConfig::PanLaw law) noexcept {
+    m_target = BalanceMatrix(balance, law);
+}
+
+void GainPair::Next(gain::ProcessorParameter& params) noexcept {
+    for (size_t i = 0; i < m_target.size(); ++i) {
+        params.pair_from[i] = m_current[i];
+        params.pair_to[i] = m_target[i];
+    }
+    m_current = m_target;
+}
+
+GainPair::Matrix GainPair::MidSideMatrix(float mid_gain, float side_gain) noexcept {
+    // left' = mid * g_m + side * g_s and right' = mid * g_m - side * g_s with mid = (l + r) / 2, side = (l - r) / 2
+    const float same = 0.5f * (mid_gain + side_gain);
+    const float cross = 0.5f * (mid_gain - side_gain);
+    return {same, cross, cross, same};
+}
+
+GainPair::Matrix GainPair::BalanceMatrix(float balance, GainConfig::PanLaw law) noexcept {
+    const float position = std::isfinite(balance) ? std::clamp(balance, -1.0f, 1.0f) : 0.0f;
+    // fraction towards the right channel
+    const float right = 0.5f * (position + 1.0f);
+    float left_gain;
+    float right_gain;
+    switch (law) {
+    case GainConfig::PanLaw::eConstantPower:
+        left_gain = std::cos(right * g_half_pi);
+        right_gain = std::sin(right * g_half_pi);
+        break;
+    case GainConfig::PanLaw::eCompromise:
+        // geometric mean of the linear pan and the constant power law
+        left_gain = std::sqrt((1.0f - right) * std::cos(right * g_half_pi));
+        right_gain = std::sqrt(right * std::sin(right * g_half_pi));
+        break;
+    case GainConfig::PanLaw::eBalance:
+    default:
+        left_gain = std::min(1.0f, 1.0f - position);
+        right_gain = std::min(1.0f, 1.0f + position);
+        break;
+    }
+    return {left_gain, 0.0f, 0.0f, right_gain};
+}
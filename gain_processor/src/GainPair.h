@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_GAIN_PAIR_H
+#define GAIN_GAIN_PAIR_H
+
+#include "Properties.h"
+
+#include <gain_processor/GainSpecification.h>
+
+#include <array>
+#include <cstdint>
+
+// Host-side state of the channel pair modes (see GainConfig::PairMode and GainProcessorDevice::process_pair).
+// Mid/side gain and balance are both a 2x2 matrix applied to (left, right); the matrix is computed here, so the
+// device applies encode, gain and decode in one pass over the pair. A new matrix is interpolated over one buffer.
+class GainPair {
+public:
+    // coefficients {left from left, left from right, right from left, right from right}
+    using Matrix = std::array<float, 4>;
+
+    GainPair() noexcept;
+
+    // gains are linear
+    void SetMidSide(float mid_gain, float side_gain) noexcept;
+    void SetBalance(float balance, GainConfig::PanLaw law) noexcept;
+
+    // write the matrix segment of the next buffer to the processor parameter and advance to the target
+    void Next(gain::ProcessorParameter& params) noexcept;
+
+    const Matrix& GetTarget() const noexcept { return m_target; }
+
+    static Matrix MidSideMatrix(float mid_gain, float side_gain) noexcept;
+    static Matrix BalanceMatrix(float balance, GainConfig::PanLaw law) noexcept;
+
+private:
+    Matrix m_current;
+    Matrix m_target;
+};
+
+#endif // GAIN_GAIN_PAIR_H
@@ -5,6 +5,10 @@
  */
 
 #include "GainProcessor.h"
+#include "GainModule.h"
+#include "Trace.h"
+
+#include <gain_processor/GainMessageStream.h>
 
 #include <processor_api/GpuTaskData.h>
 #include <processor_api/PortChangedFlags.h>
@@ -12,42 +16,92 @@
 #include <processor_api/MemoryManager.h>
 
 #include <algorithm>
+#include <cstring>
 #include <map>
+#include <utility>
 
 using namespace GPUA::processor::v2;
 
-#if defined(GPU_AUDIO_MAC)
-static constexpr uint32_t g_max_threads_per_block {256u};
-#else
-static constexpr uint32_t g_max_threads_per_block {512u};
-#endif
-
-namespace {
-template <typename T>
-T divup(T a, T b) {
-    return (a + b - 1) / b;
-}
-} // namespace
-
 Module& GainProcessor::GetModule() const noexcept {
     return m_module;
 }
 
 ErrorCode GainProcessor::SetData(void* data, uint32_t data_size) noexcept {
-    // make sure we get valid data
-    if (data != nullptr && data_size == sizeof(GainConfig::Parameters)) {
-        const GainConfig::Parameters* params = reinterpret_cast<const GainConfig::Parameters*>(data);
-        // determine the message type - the processor only supports a gain message
-        if (params->ThisMessage == params->GainMessage) {
-            m_gain_value = params->gain_value;
-            return ErrorCode::eSuccess;
+    // several messages at once (see GainMessageStream.h); parsed in place, as this runs in PrepareForProcess
+    const GainConfig::MessageStreamReader stream {data, data_size};
+    if (stream.IsStream()) {
+        // a corrupt stream is rejected as a whole, before any of its messages is applied
+        if (!stream.Validate()) {
+            return ErrorCode::eFail;
         }
+        ErrorCode result = ErrorCode::eSuccess;
+        stream.ForEach([&](const GainConfig::MessageStreamReader::Record& record) {
+            // records with unknown ids come from newer minor versions and are skipped
+            if (ApplyMessage(record.payload, record.size, true) == ErrorCode::eFail) {
+                result = ErrorCode::eFail;
+            }
+        });
+        return result;
     }
-    return ErrorCode::eFail;
+    return ApplyMessage(data, data_size, false) == ErrorCode::eSuccess ? ErrorCode::eSuccess : ErrorCode::eFail;
+}
+
+ErrorCode GainProcessor::ApplyMessage(const void* data, uint32_t data_size, bool extensible) noexcept {
+    // make sure we get valid data
+    if (data == nullptr || data_size < sizeof(uint32_t)) {
+        return ErrorCode::eFail;
+    }
+    // the message is at least as large as we know it, and exactly as large outside of a stream
+    const auto fits = [&](size_t size) { return extensible ? data_size >= size : data_size == size; };
+    // determine the message type - the first member of every message; messages of the same size are told apart by it alone
+    uint32_t message;
+    std::memcpy(&message, data, sizeof(message));
+    // the first version of the gain message (a linear gain without ramp) is accepted as well
+    GainConfig::Parameters params;
+    if (message == GainConfig::Parameters::GainMessage && (fits(sizeof(GainConfig::Parameters)) || data_size == GainConfig::g_parameters_v1_size) &&
+        GainConfig::ReadVersioned(data, data_size, GainConfig::g_parameters_v1_size, params)) {
+        m_settings.SetGain(params);
+        return ErrorCode::eSuccess;
+    }
+    // the pair messages are only accepted in the pair mode the processor was created with
+    if (message == GainConfig::MidSideParameters::MidSideMessage && fits(sizeof(GainConfig::MidSideParameters)) &&
+        m_settings.SetMidSide(*reinterpret_cast<const GainConfig::MidSideParameters*>(data))) {
+        return ErrorCode::eSuccess;
+    }
+    if (message == GainConfig::BalanceParameters::BalanceMessage && fits(sizeof(GainConfig::BalanceParameters)) &&
+        m_settings.SetBalance(*reinterpret_cast<const GainConfig::BalanceParameters*>(data))) {
+        return ErrorCode::eSuccess;
+    }
+    // distinguish messages the processor rejects from ones it does not know (skipped in a stream)
+    const bool known = message == GainConfig::Parameters::GainMessage || message == GainConfig::MidSideParameters::MidSideMessage ||
+        message == GainConfig::BalanceParameters::BalanceMessage;
+    return known ? ErrorCode::eFail : ErrorCode::eUnsupported;
 }
 
 ErrorCode GainProcessor::GetData(void* data, uint32_t& data_size) const noexcept {
-    // not implemented; could potentially satisfy user queries
+    // the processor answers the sanitize counter and the pool statistics queries
+    if (data != nullptr && data_size == sizeof(GainConfig::PoolInfo)) {
+        auto info = reinterpret_cast<GainConfig::PoolInfo*>(data);
+        if (info->ThisMessage == info->PoolInfoMessage) {
+            m_module.GetPoolInfo(*info);
+            return ErrorCode::eSuccess;
+        }
+    }
+    if (data != nullptr && data_size >= GainConfig::g_sanitize_info_v1_size && data_size <= sizeof(GainConfig::SanitizeInfo)) {
+        GainConfig::SanitizeInfo info;
+        std::memcpy(&info, data, sizeof(info.ThisMessage));
+        if (info.ThisMessage == info.SanitizeInfoMessage) {
+            // where the counters are produced on the device; the host reads them from the transferred counter port.
+            // The port data is planar, one capacity (a single uint32_t) per channel (see GainInputPort::UpdateCounterPort)
+            info.enabled = m_settings.IsSanitizing() ? 1u : 0u;
+            info.counter_port = 1u;
+            info.counter_count = m_settings.IsSanitizing() ? m_input_port.m_channel_count : 0u;
+            info.counter_stride = static_cast<uint32_t>(sizeof(uint32_t));
+            // older hosts get the members they know
+            std::memcpy(data, &info, data_size);
+            return ErrorCode::eSuccess;
+        }
+    }
     return ErrorCode::eFail;
 }
 
@@ -59,7 +113,7 @@ uint32_t GainProcessor::GetInputPortCount() const noexcept {
 ErrorCode GainProcessor::GetInputPort(uint32_t index, InputPort*& port) noexcept {
     // return the requested port
     if (index == 0) {
-        port = m_input_port.get();
+        port = &m_input_port;
         return ErrorCode::eSuccess;
     }
     // or nullptr if the index is out-of-bounds (!= 0 in this case)
@@ -68,41 +122,46 @@ ErrorCode GainProcessor::GetInputPort(uint32_t index, InputPort*& port) noexcept
 }
 
 ErrorCode GainProcessor::OnBlueprintRebuild(const ProcessorBlueprint*& blueprint) noexcept {
+    // trace rings are taken here, off the real-time path, rather than by the first event of a processing thread
+    GAIN_TRACE_REGISTER_THREAD();
+    GAIN_TRACE_SCOPE("GainProcessor::OnBlueprintRebuild");
     // if something changed that requires change to the task configuration
-    if (m_changed || m_input_port->m_changed) {
-        // the processor requires one block per input channel
-        m_gpu_task.block_count = m_input_port->m_channel_count;
-        // optimally we have one thread per block; we use multiples of 32 threads up to at most `g_max_threads_per_block`
-        m_gpu_task.thread_count = std::min(g_max_threads_per_block, divup(m_input_port->m_max_buffer_size, 32u) * 32u);
+    if (m_changed || m_input_port.m_changed) {
+        // the processor requires one block per input channel, or per channel pair in a pair mode
+        m_gpu_task.block_count = m_settings.GetBlockCount(m_input_port.m_channel_count);
+        // optimally we have one thread per sample; we use multiples of the platform's wavefront size up to a block size
+        // limit that depends on whether there are enough channels to occupy the GPU (see LaunchTuning.h)
+        m_gpu_task.thread_count = m_settings.GetThreadCount(m_input_port.m_channel_count, m_input_port.m_max_buffer_size);
+        // the sanitizing, limiting and saturating tasks work in shared memory
+        m_gpu_task.shared_mem_size = m_settings.GetSharedMemorySize(m_gpu_task.thread_count);
         // reset change indicators
-        m_changed = m_input_port->m_changed = false;
+        m_changed = m_input_port.m_changed = false;
     }
     blueprint = &m_proc_data;
     return ErrorCode::eSuccess;
 }
 
 ErrorCode GainProcessor::PrepareForProcess(const LaunchData& data, uint32_t expected_chunks) noexcept {
-    // process the provided user-data
+    GAIN_TRACE_SCOPE("GainProcessor::PrepareForProcess");
+    // process the provided user-data: a single message or a stream of them (see GainMessageStream.h)
     SetData(data.app_data, data.app_data_size);
 
     // communicate a blueprint rebuild if anything changed that requires one
-    if (m_changed || m_input_port->m_changed)
+    if (m_changed || m_input_port.m_changed)
         return ErrorCode::eBlueprintUpdateNeeded;
 
     return ErrorCode::eNoChangesNeeded;
 }
 
 ErrorCode GainProcessor::PrepareChunk(void* proc_data, void** task_data, uint32_t chunk_id) noexcept {
+    GAIN_TRACE_SCOPE("GainProcessor::PrepareChunk");
     // set ProcessorData input for the GPU task in the next launch
+    // (the offline renderer fills it through the same GainTaskSettings)
     auto proc_params = reinterpret_cast<gain::ProcessorParameter*>(proc_data);
-    // number of input channels
-    proc_params->channel_count = m_input_port->m_channel_count;
-    // maximum number of samples per channel the input buffer can hold
-    proc_params->buffer_capacity = m_input_port->m_max_buffer_size;
-    // current number of samples per channel in the input buffer (<= buffer_capacity)
-    proc_params->buffer_length = m_input_port->m_current_buffer_size;
-    // the gain to apply to each sample in each channel of the buffer
-    proc_params->gain = m_gain_value;
+    // per-channel device state starts over after the channel layout changed (once, not for every chunk)
+    m_settings.PrepareChunk(m_input_port.m_channel_count, m_input_port.m_max_buffer_size, m_input_port.m_current_buffer_size,
+        m_input_port.m_state_reset, *proc_params);
+    m_input_port.m_state_reset = false;
     return ErrorCode::eSuccess;
 }
 
@@ -113,32 +172,73 @@ ProcessorProfiler* GainProcessor::GetProcessorProfiler() noexcept {
     return nullptr;
 }
 
-GainProcessor::GainProcessor(ProcessorSpecification& specification, Module& module) :
-    m_module {module},
-    m_proc_data {1u, sizeof(gain::ProcessorParameter), ProcessorEndCallback::eNoCallback, 1u, &m_gpu_task},
-    m_port_factory {specification.port_factory},
-    m_memory_manager {specification.memory_manager} {
-    // Get the user-data for processor construction from the ProcessorSpecification
-    const GainConfig::Specification* spec = reinterpret_cast<const GainConfig::Specification*>(specification.user_data);
+ErrorCode GainProcessor::Create(ProcessorSpecification& specification, GainModule& module, void* memory, GainProcessor*& processor) noexcept {
+    processor = nullptr;
+    // Get the user-data for processor construction from the ProcessorSpecification; older and newer versions of
+    // GainConfig::Specification are accepted (see GainConfig::ReadVersioned)
+    GainConfig::Specification spec;
     // make sure the user-data is what we expect it to be, i.e., a GainConfig::Specification
-    if (specification.data_size != sizeof(GainConfig::Specification) || spec->ThisType != spec->GainConstructionType) {
-        throw std::runtime_error("Error in GainProcessor::GainProcessor: invalid specification provided");
+    if (memory == nullptr ||
+        !GainConfig::ReadVersioned(specification.user_data, specification.data_size, GainConfig::g_specification_v1_size, spec) ||
+        spec.ThisType != spec.GainConstructionType) {
+        return ErrorCode::eFail;
+    }
+    // only combinations of modes that one of the device tasks implements
+    if (!GainTaskSettings::IsSupported(spec)) {
+        return ErrorCode::eFail;
     }
     // use the data provided in the GainConfig::Specification
-    m_gain_value = spec->params.gain_value;
-
-    // specify what type of output port the processor has and create it
-    PortInfo output_port_info {};
-    output_port_info.type = PortType::eRegularPort;
-    output_port_info.data_type = PortDataType::eSample32;
-    m_output_port = m_port_factory.CreateDataPort(0u, output_port_info);
+    const GainTaskSettings settings {spec};
+    const bool stateful = settings.GetStateSize() != 0u;
+    // create the output port; the sanitize counters and the device state of the limiter and the oversampler get their
+    // own output ports, which are configured by the input port. The port factory may throw (e.g., std::bad_alloc), so
+    // the ports are created here rather than in the constructor
+    OutputPortPointer output_port {0, 0};
+    OutputPortPointer counter_port {0, 0};
+    OutputPortPointer state_port {0, 0};
+    try {
+        output_port = specification.port_factory.CreateDataPort(0u, SamplePortInfo());
+        if (spec.sanitize != 0u) {
+            counter_port = specification.port_factory.CreateDataPort(1u, SamplePortInfo());
+        }
+        if (stateful) {
+            state_port = specification.port_factory.CreateDataPort(settings.GetStatePort(), SamplePortInfo());
+        }
+    }
+    catch (...) {
+        return ErrorCode::eFail;
+    }
+    // the port factory returns empty port pointers if it can not create a port
+    if (output_port.get() == nullptr || (spec.sanitize != 0u && counter_port.get() == nullptr) || (stateful && state_port.get() == nullptr)) {
+        return ErrorCode::eFail;
+    }
+    processor = new (memory) GainProcessor(specification, module, settings, std::move(output_port), std::move(counter_port), std::move(state_port));
+    return ErrorCode::eSuccess;
+}
 
-    // create the processor's input port
-    m_input_port = std::make_unique<GainInputPort>(m_output_port.get());
+PortInfo GainProcessor::SamplePortInfo() noexcept {
+    // specify what type of output port the processor has
+    PortInfo port_info {};
+    port_info.type = PortType::eRegularPort;
+    port_info.data_type = PortDataType::eSample32;
+    return port_info;
+}
 
-    // the processor only has one task/step and it's index is 0. See `DeclareProcessorStep` in `GainProcessor.cu`
-    m_gpu_task.entry_idx = 0u;
-    // the task does not need any per-block shared memory
+GainProcessor::GainProcessor(ProcessorSpecification& specification, GainModule& module, const GainTaskSettings& settings,
+    OutputPortPointer output_port, OutputPortPointer counter_port, OutputPortPointer state_port) noexcept :
+    m_module {module},
+    m_proc_data {1u, sizeof(gain::ProcessorParameter), ProcessorEndCallback::eNoCallback, 1u, &m_gpu_task},
+    m_port_factory {specification.port_factory},
+    m_memory_manager {specification.memory_manager},
+    m_output_port {std::move(output_port)},
+    m_counter_port {std::move(counter_port)},
+    m_state_port {std::move(state_port)},
+    m_settings {settings},
+    // create the processor's input port; it sizes the state port for the channels and the pair modes take complete pairs
+    m_input_port {m_output_port.get(), m_counter_port.get(), m_state_port.get(), m_settings.GetStateSize(), m_settings.GetChannelMultiple()} {
+    // the processor runs one task/step, selected by the specification
+    m_gpu_task.entry_idx = m_settings.GetTaskIndex();
+    // the plain task does not need any per-block shared memory (see OnBlueprintRebuild for the sanitizing task)
     m_gpu_task.shared_mem_size = 0u;
     // and it does not take task parameters. see `using TaskParameter = void;` in `Properties.h`)
     m_gpu_task.task_param_size = 0u;
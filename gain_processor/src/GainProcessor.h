@@ -8,6 +8,7 @@
 #define GAIN_GAIN_PROCESSOR_H
 
 #include "GainInputPort.h"
+#include "GainTaskSettings.h"
 #include "Properties.h"
 
 #include <gain_processor/GainSpecification.h>
@@ -25,9 +26,13 @@
 #include <fstream>
 #include <map>
 
+class GainModule;
+
 class GainProcessor : public GPUA::processor::v2::Processor {
 public:
-    explicit GainProcessor(GPUA::processor::v2::ProcessorSpecification& specification, GPUA::processor::v2::Module& module);
+    // Validates the specification and constructs the processor in `memory` (sizeof(GainProcessor) bytes, see
+    // GainModule's processor pool). Does not throw; returns eFail for an invalid specification.
+    static GPUA::processor::v2::ErrorCode Create(GPUA::processor::v2::ProcessorSpecification& specification, GainModule& module, void* memory, GainProcessor*& processor) noexcept;
     ~GainProcessor() = default;
 
     // Copy ctor and copy assignment are deleted along with move assignment operator deletion
@@ -53,17 +58,35 @@ public:
     ////////////////////////////////
 
 private:
-    GPUA::processor::v2::Module& m_module;
+    // takes the output ports created by Create; `counter_port` is empty unless the specification asks for sanitizing
+    // and `state_port` unless the task keeps state on the device
+    GainProcessor(GPUA::processor::v2::ProcessorSpecification& specification, GainModule& module, const GainTaskSettings& settings,
+        GPUA::processor::v2::OutputPortPointer output_port, GPUA::processor::v2::OutputPortPointer counter_port,
+        GPUA::processor::v2::OutputPortPointer state_port) noexcept;
+
+    static GPUA::processor::v2::PortInfo SamplePortInfo() noexcept;
+
+    // applies a single message; `extensible` accepts payloads with members appended by newer minor versions (see
+    // GainConfig::MessageStream). Returns eUnsupported for unknown message ids and eFail for rejected messages
+    GPUA::processor::v2::ErrorCode ApplyMessage(const void* data, uint32_t data_size, bool extensible) noexcept;
+
+    GainModule& m_module;
     GPUA::processor::v2::PortFactory& m_port_factory;
     GPUA::processor::v2::MemoryManager& m_memory_manager;
 
     GPUA::processor::v2::GpuTaskData m_gpu_task;
     GPUA::processor::v2::ProcessorBlueprint m_proc_data;
 
-    std::unique_ptr<GainInputPort> m_input_port;
     GPUA::processor::v2::OutputPortPointer m_output_port {0, 0};
-
-    float m_gain_value {};
+    // receives the per-channel sanitize counters; only created if the specification asks for sanitizing
+    GPUA::processor::v2::OutputPortPointer m_counter_port {0, 0};
+    // per-channel state of the limiter and the oversampler; only created for tasks that keep state (see
+    // GainTaskSettings::GetStateSize), so plain gain processors reserve no device memory for it
+    GPUA::processor::v2::OutputPortPointer m_state_port {0, 0};
+    // the task, its gain, limiter, pair matrix and oversampler
+    GainTaskSettings m_settings;
+    // the input port is part of the processor, so creating a processor takes a single allocation (from the module's pool)
+    GainInputPort m_input_port;
 
     bool m_changed {true};
 };
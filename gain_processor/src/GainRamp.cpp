@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "GainRamp.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// log ramps towards or from silence end at -120 dB and jump to 0 after the last ramp sample
+constexpr float g_min_log2_gain {-19.93157f};
+
+float ToLog2(float gain) {
+    return gain > 0.0f ? std::max(std::log2(gain), g_min_log2_gain) : g_min_log2_gain;
+}
+
+} // namespace
+
+GainRamp::GainRamp(float gain) noexcept :
+    m_target {gain} {
+}
+
+void GainRamp::SetTarget(float target, uint32_t length, bool in_decibel) noexcept {
+    const float current = GetCurrent();
+    m_target = target;
+    m_position = 0u;
+    // log2 interpolation only works between non-negative gains
+    m_in_log2 = in_decibel && current >= 0.0f && target >= 0.0f;
+    m_length = current == target ? 0u : length;
+    m_from = m_in_log2 ? ToLog2(current) : current;
+    m_to = m_in_log2 ? ToLog2(target) : target;
+}
+
+void GainRamp::Next(uint32_t buffer_length, gain::ProcessorParameter& params) noexcept {
+    params.gain = m_target;
+    if (m_position >= m_length) {
+        params.ramp_length = 0u;
+        params.ramp_start = m_target;
+        params.ramp_step = 0.0f;
+        params.ramp_in_log2 = 0u;
+        return;
+    }
+
+    params.ramp_length = std::min(m_length - m_position, buffer_length);
+    params.ramp_step = (m_to - m_from) / static_cast<float>(m_length);
+    params.ramp_start = ValueAt(m_position);
+    params.ramp_in_log2 = m_in_log2 ? 1u : 0u;
+    m_position += params.ramp_length;
+}
+
+float GainRamp::GetCurrent() const noexcept {
+    if (m_position >= m_length) {
+        return m_target;
+    }
+    const float value = ValueAt(m_position);
+    return m_in_log2 ? std::exp2(value) : value;
+}
+
+float GainRamp::ValueAt(uint32_t position) const noexcept {
+    return m_from + (m_to - m_from) * (static_cast<float>(position) / static_cast<float>(m_length));
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_GAIN_RAMP_H
+#define GAIN_GAIN_RAMP_H
+
+#include "Properties.h"
+
+#include <cstdint>
+
+// Host-side state of a gain ramp that spans one or more buffers. For every launch it provides the
+// segment of the ramp that falls into the buffer (see gain::ProcessorParameter); the device interpolates
+// the samples. Ramps either run linearly in the gain or linearly in the log2 of the gain, i.e., in dB.
+class GainRamp {
+public:
+    explicit GainRamp(float gain = 0.0f) noexcept;
+
+    // start a ramp from the current gain to `target` over `length` samples; 0 jumps immediately
+    void SetTarget(float target, uint32_t length, bool in_decibel) noexcept;
+
+    // write the ramp segment for the next `buffer_length` samples and advance the ramp
+    void Next(uint32_t buffer_length, gain::ProcessorParameter& params) noexcept;
+
+    // gain at the current position of the ramp
+    float GetCurrent() const noexcept;
+    float GetTarget() const noexcept { return m_target; }
+
+private:
+    // gain domain value of the ramp at `position`
+    float ValueAt(uint32_t position) const noexcept;
+
+    float m_target;
+    // ramp end points in the ramp domain (gain or log2 of the gain)
+    float m_from {0.0f};
+    float m_to {0.0f};
+    uint32_t m_length {0u};
+    uint32_t m_position {0u};
+    bool m_in_log2 {false};
+};
+
+#endif // GAIN_GAIN_RAMP_H
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "GainTaper.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+struct TaperPoint {
+    float position;
+    float decibel;
+};
+
+// console-style fader scale; positions below the first point fade to silence
+constexpr std::array<TaperPoint, 6> g_audio_taper {{
+    {0.05f, -60.0f},
+    {0.15f, -40.0f},
+    {0.30f, -24.0f},
+    {0.50f, -12.0f},
+    {0.75f, 0.0f},
+    {1.00f, 10.0f},
+}};
+
+constexpr float g_log_taper_min_decibel {-60.0f};
+constexpr float g_log_taper_max_decibel {6.0f};
+
+double DecibelToLinearExact(double decibel) {
+    return std::pow(10.0, decibel / 20.0);
+}
+
+double FaderToLinearExact(GainConfig::FaderTaper taper, double position) {
+    switch (taper) {
+    case GainConfig::FaderTaper::eLinear:
+        return position;
+    case GainConfig::FaderTaper::eLogarithmic:
+        if (position <= 0.0) {
+            return 0.0;
+        }
+        return DecibelToLinearExact(g_log_taper_min_decibel + position * (g_log_taper_max_decibel - g_log_taper_min_decibel));
+    case GainConfig::FaderTaper::eAudio:
+    default: {
+        const TaperPoint& first = g_audio_taper.front();
+        if (position < first.position) {
+            // fade linearly in amplitude from the first point to silence
+            return DecibelToLinearExact(first.decibel) * position / first.position;
+        }
+        for (size_t i = 1; i < g_audio_taper.size(); ++i) {
+            const TaperPoint& a = g_audio_taper[i - 1];
+            const TaperPoint& b = g_audio_taper[i];
+            if (position <= b.position) {
+                const double t = (position - a.position) / (b.position - a.position);
+                return DecibelToLinearExact(a.decibel + t * (b.decibel - a.decibel));
+            }
+        }
+        return DecibelToLinearExact(g_audio_taper.back().decibel);
+    }
+    }
+}
+
+// linear interpolation between the table entries around a fractional index
+template <size_t N>
+float Lookup(const std::array<float, N>& table, float index) {
+    const float clamped = std::min(std::max(index, 0.0f), static_cast<float>(N - 1));
+    const auto i = std::min(static_cast<size_t>(clamped), N - 2);
+    const float t = clamped - static_cast<float>(i);
+    return table[i] + t * (table[i + 1] - table[i]);
+}
+
+} // namespace
+
+const GainTaper& GainTaper::Get(GainConfig::FaderTaper taper) noexcept {
+    static const GainTaper linear {GainConfig::FaderTaper::eLinear};
+    static const GainTaper logarithmic {GainConfig::FaderTaper::eLogarithmic};
+    static const GainTaper audio {GainConfig::FaderTaper::eAudio};
+    switch (taper) {
+    case GainConfig::FaderTaper::eLinear:
+        return linear;
+    case GainConfig::FaderTaper::eLogarithmic:
+        return logarithmic;
+    case GainConfig::FaderTaper::eAudio:
+    default:
+        return audio;
+    }
+}
+
+GainTaper::GainTaper(GainConfig::FaderTaper taper) noexcept {
+    for (uint32_t i = 0; i < DecibelTableSize; ++i) {
+        m_decibel_table[i] = static_cast<float>(DecibelToLinearExact(MinDecibel + static_cast<double>(i) / DecibelStepsPerUnit));
+    }
+    // the bottom of the range mutes
+    m_decibel_table[0] = 0.0f;
+
+    for (uint32_t i = 0; i < FaderTableSize; ++i) {
+        m_fader_table[i] = static_cast<float>(FaderToLinearExact(taper, static_cast<double>(i) / (FaderTableSize - 1u)));
+    }
+}
+
+float GainTaper::ToLinear(GainConfig::GainUnit unit, float value) const noexcept {
+    switch (unit) {
+    case GainConfig::GainUnit::eDecibel:
+        return DecibelToLinear(value);
+    case GainConfig::GainUnit::eFader:
+        return FaderToLinear(value);
+    case GainConfig::GainUnit::eLinear:
+    default:
+        return value;
+    }
+}
+
+float GainTaper::DecibelToLinear(float decibel) const noexcept {
+    if (!(decibel > MinDecibel)) {
+        return 0.0f;
+    }
+    return Lookup(m_decibel_table, (decibel - MinDecibel) * DecibelStepsPerUnit);
+}
+
+float GainTaper::FaderToLinear(float position) const noexcept {
+    // NaN positions end up at 0, i.e., muted
+    return Lookup(m_fader_table, (position == position ? position : 0.0f) * (FaderTableSize - 1u));
+}
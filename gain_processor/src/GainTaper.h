@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_GAIN_TAPER_H
+#define GAIN_GAIN_TAPER_H
+
+#include <gain_processor/GainSpecification.h>
+
+#include <array>
+#include <cstdint>
+
+// Converts decibel and fader values to linear gains through precomputed lookup tables.
+// The tables are built once per taper and shared by all processors (see GainTaper::Get).
+class GainTaper {
+public:
+    // everything at or below is muted
+    static constexpr float MinDecibel {-120.0f};
+    // everything above is clamped
+    static constexpr float MaxDecibel {24.0f};
+
+    // returns the shared taper instance; builds its tables on first use
+    static const GainTaper& Get(GainConfig::FaderTaper taper) noexcept;
+
+    float ToLinear(GainConfig::GainUnit unit, float value) const noexcept;
+
+    float DecibelToLinear(float decibel) const noexcept;
+    float FaderToLinear(float position) const noexcept;
+
+private:
+    explicit GainTaper(GainConfig::FaderTaper taper) noexcept;
+
+    // 1/8 dB resolution; linear interpolation keeps the error below 0.001 dB
+    static constexpr uint32_t DecibelStepsPerUnit {8u};
+    static constexpr uint32_t DecibelTableSize {static_cast<uint32_t>(MaxDecibel - MinDecibel) * DecibelStepsPerUnit + 1u};
+    static constexpr uint32_t FaderTableSize {1025u};
+
+    std::array<float, DecibelTableSize> m_decibel_table {};
+    std::array<float, FaderTableSize> m_fader_table {};
+};
+
+#endif // GAIN_GAIN_TAPER_H
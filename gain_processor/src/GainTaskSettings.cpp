@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "GainTaskSettings.h"
+
+#include "LaunchTuning.h"
+
+#include <cmath>
+
+namespace {
+
+// A NaN or infinite gain would turn every sample into a non-finite product. Sanitizing processors silence the
+// channel instead of flushing (and counting) each sample on the device.
+float SanitizeGain(float gain, bool sanitize) noexcept {
+    return sanitize && !std::isfinite(gain) ? 0.0f : gain;
+}
+
+} // namespace
+
+GainTaskSettings::GainTaskSettings(const GainConfig::Specification& specification) noexcept :
+    m_taper {&GainTaper::Get(specification.taper)},
+    m_gain {SanitizeGain(m_taper->ToLinear(specification.gain_unit, specification.gain_value), specification.sanitize != 0u)},
+    m_sanitize {specification.sanitize != 0u},
+    m_limiter {specification},
+    m_limit {specification.limit != 0u},
+    m_pair_mode {specification.pair_mode},
+    m_oversampler {specification},
+    m_saturate {specification.saturation != GainConfig::Saturation::eNone} {
+}
+
+bool GainTaskSettings::IsSupported(const GainConfig::Specification& specification) noexcept {
+    const bool pair = specification.pair_mode != GainConfig::PairMode::eNone;
+    const bool sanitize_or_limit = specification.sanitize != 0u || specification.limit != 0u;
+    if (pair && sanitize_or_limit) {
+        return false;
+    }
+    return specification.saturation == GainConfig::Saturation::eNone || !(sanitize_or_limit || pair);
+}
+
+uint32_t GainTaskSettings::GetTaskIndex() const noexcept {
+    if (m_saturate) {
+        return 4u;
+    }
+    if (m_pair_mode != GainConfig::PairMode::eNone) {
+        return 3u;
+    }
+    return m_limit ? 2u : (m_sanitize ? 1u : 0u);
+}
+
+uint32_t GainTaskSettings::GetBlockCount(uint32_t channel_count) const noexcept {
+    return m_pair_mode != GainConfig::PairMode::eNone ? channel_count / 2u : channel_count;
+}
+
+uint32_t GainTaskSettings::GetThreadCount(uint32_t channel_count, uint32_t buffer_capacity) const noexcept {
+    return gain::SelectThreadCount(gain::g_launch_tuning, GetBlockCount(channel_count), buffer_capacity);
+}
+
+uint32_t GainTaskSettings::GetSharedMemorySize(uint32_t thread_count) const noexcept {
+    if (m_limit) {
+        // the limiter works on tiles of one sample per thread plus the look-ahead in shared memory
+        return m_limiter.GetSharedMemorySize(thread_count);
+    }
+    if (m_saturate) {
+        // the oversampler stages the taps and tiles of one sample per thread plus the filter histories
+        return m_oversampler.GetSharedMemorySize(thread_count);
+    }
+    // the sanitizing task reduces one counter per thread in shared memory
+    return m_sanitize ? thread_count * static_cast<uint32_t>(sizeof(uint32_t)) : 0u;
+}
+
+uint32_t GainTaskSettings::GetStateSize() const noexcept {
+    if (m_limit) {
+        return m_limiter.GetStateSize();
+    }
+    return m_saturate ? m_oversampler.GetStateSize() : 0u;
+}
+
+uint32_t GainTaskSettings::GetStatePort() const noexcept {
+    return m_sanitize ? 2u : 1u;
+}
+
+uint32_t GainTaskSettings::GetChannelMultiple() const noexcept {
+    return m_pair_mode != GainConfig::PairMode::eNone ? 2u : 1u;
+}
+
+void GainTaskSettings::SetGain(const GainConfig::Parameters& params) noexcept {
+    // decibel and fader values are converted here, on the control thread, through the taper's lookup tables
+    const float gain = SanitizeGain(m_taper->ToLinear(params.unit, params.gain_value), m_sanitize);
+    // decibel and fader changes ramp in dB for perceptually even fades
+    m_gain.SetTarget(gain, params.ramp_length, params.unit != GainConfig::GainUnit::eLinear);
+}
+
+bool GainTaskSettings::SetMidSide(const GainConfig::MidSideParameters& params) noexcept {
+    if (m_pair_mode != GainConfig::PairMode::eMidSide) {
+        return false;
+    }
+    m_pair.SetMidSide(m_taper->ToLinear(params.unit, params.mid_gain), m_taper->ToLinear(params.unit, params.side_gain));
+    return true;
+}
+
+bool GainTaskSettings::SetBalance(const GainConfig::BalanceParameters& params) noexcept {
+    if (m_pair_mode != GainConfig::PairMode::eBalance) {
+        return false;
+    }
+    m_pair.SetBalance(params.balance, params.law);
+    return true;
+}
+
+void GainTaskSettings::PrepareChunk(uint32_t channel_count, uint32_t buffer_capacity, uint32_t buffer_length, bool reset_state,
+    gain::ProcessorParameter& params) noexcept {
+    // number of input channels
+    params.channel_count = channel_count;
+    // maximum number of samples per channel the input buffer can hold
+    params.buffer_capacity = buffer_capacity;
+    // current number of samples per channel in the input buffer (<= buffer_capacity)
+    params.buffer_length = buffer_length;
+    // the gain to apply to each sample in each channel of the buffer, ramped if it just changed
+    m_gain.Next(buffer_length, params);
+    // per-channel device state starts over after the channel layout changed
+    params.reset_state = reset_state ? 1u : 0u;
+    params.state_port = GetStatePort();
+    params.state_stride = GetStateSize();
+    // the limiter settings, if the task is process_limited
+    if (m_limit) {
+        m_limiter.Apply(params, m_sanitize);
+    }
+    // the pair matrix, if the task is process_pair
+    if (m_pair_mode != GainConfig::PairMode::eNone) {
+        m_pair.Next(params);
+    }
+    // the saturation settings and oversampling filter, if the task is process_saturated
+    if (m_saturate) {
+        m_oversampler.Apply(params);
+    }
+}
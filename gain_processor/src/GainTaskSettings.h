@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_GAIN_TASK_SETTINGS_H
+#define GAIN_GAIN_TASK_SETTINGS_H
+
+#include "GainLimiter.h"
+#include "GainOversampler.h"
+#include "GainPair.h"
+#include "GainRamp.h"
+#include "GainTaper.h"
+#include "Properties.h"
+
+#include <gain_processor/GainSpecification.h>
+
+#include <cstdint>
+
+// Host-side state of the device task of one processor: which task runs, its launch requirements and the
+// gain::ProcessorParameter of every launch. Shared by GainProcessor and the offline renderer (gain_offline), so
+// real-time and offline processing take the same code path from the specification and the messages to the device.
+class GainTaskSettings {
+public:
+    explicit GainTaskSettings(const GainConfig::Specification& specification) noexcept;
+
+    // false if the specification combines modes no task implements: the pair task neither sanitizes nor limits, and
+    // the saturation task does neither of the three
+    static bool IsSupported(const GainConfig::Specification& specification) noexcept;
+
+    // the task to run: `process` (index 0), `process_sanitized` (index 1), `process_limited` (index 2),
+    // `process_pair` (index 3) or `process_saturated` (index 4). See `DeclareProcessorStep` in `GainProcessor.cu`
+    uint32_t GetTaskIndex() const noexcept;
+    // one block per channel, or per channel pair in a pair mode
+    uint32_t GetBlockCount(uint32_t channel_count) const noexcept;
+    // threads per block for `channel_count` channels of `buffer_capacity` samples each: one thread per sample, in
+    // multiples of the platform's wavefront size up to the block size limit of gain::g_launch_tuning
+    uint32_t GetThreadCount(uint32_t channel_count, uint32_t buffer_capacity) const noexcept;
+    // bytes of shared memory the task needs for blocks of `thread_count` threads
+    uint32_t GetSharedMemorySize(uint32_t thread_count) const noexcept;
+    // floats of device state the task keeps per channel from one launch to the next; 0 for the stateless tasks,
+    // which need no state port
+    uint32_t GetStateSize() const noexcept;
+    // index of the output port that holds the state: after the audio output and the sanitize counters, if any
+    uint32_t GetStatePort() const noexcept;
+    // the pair modes need complete pairs
+    uint32_t GetChannelMultiple() const noexcept;
+
+    // apply a message (see GainProcessor::SetData); the pair messages return false unless the task runs in their mode
+    void SetGain(const GainConfig::Parameters& params) noexcept;
+    bool SetMidSide(const GainConfig::MidSideParameters& params) noexcept;
+    bool SetBalance(const GainConfig::BalanceParameters& params) noexcept;
+
+    // write the parameters of the next launch over `buffer_length` samples and advance all ramps; `reset_state` is
+    // set for the first launch after the channel layout changed (and the state port was resized)
+    void PrepareChunk(uint32_t channel_count, uint32_t buffer_capacity, uint32_t buffer_length, bool reset_state,
+        gain::ProcessorParameter& params) noexcept;
+
+    bool IsSanitizing() const noexcept { return m_sanitize; }
+    GainConfig::PairMode GetPairMode() const noexcept { return m_pair_mode; }
+
+private:
+    // maps decibel and fader values to linear gains (shared lookup tables, see GainTaper::Get)
+    const GainTaper* m_taper;
+    // the gain and its ramp towards the last received value
+    GainRamp m_gain;
+    bool m_sanitize;
+    // optional brickwall limiter after the gain (process_limited)
+    GainLimiter m_limiter;
+    bool m_limit;
+    // mid/side or balance matrix of channel pairs (process_pair)
+    GainPair m_pair;
+    GainConfig::PairMode m_pair_mode;
+    // optional oversampled saturation after the gain (process_saturated)
+    GainOversampler m_oversampler;
+    bool m_saturate;
+};
+
+#endif // GAIN_GAIN_TASK_SETTINGS_H
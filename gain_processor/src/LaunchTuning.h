@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_LAUNCH_TUNING_H
+#define GAIN_LAUNCH_TUNING_H
+
+#include "ArchList.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace gain {
+
+enum class LaunchPlatform : uint32_t {
+    eNvidia,
+    // GCN/CDNA (gfx8, gfx9) execute wave64
+    eAmdWave64,
+    // RDNA (gfx10 and newer) execute wave32 by default
+    eAmdWave32,
+    eMetal
+};
+
+// Launch parameters of the gain task for one platform (see GainProcessor::OnBlueprintRebuild)
+struct LaunchTuning {
+    LaunchPlatform platform;
+    // threads that execute in lockstep (warp, wavefront, SIMD-group); block sizes are multiples of it
+    uint32_t wavefront_size;
+    // block size limit once there are enough blocks to occupy the whole GPU
+    uint32_t preferred_block_size;
+    // block size limit for few channels, where wide blocks are the only source of parallelism
+    uint32_t max_block_size;
+    // number of blocks (channels) from which on the GPU is considered occupied
+    uint32_t saturating_block_count;
+};
+
+// clang-format off
+// The block size limits are those of the former fixed g_max_threads_per_block (512, 256 on Metal); the emulation can
+// not tell how the GPU schedules blocks (see `gain_benchmark autotune`), so change them only from device profiles
+constexpr std::array<LaunchTuning, 4> g_launch_tunings {{
+    {LaunchPlatform::eNvidia,    32u, 512u, 512u,  80u},
+    {LaunchPlatform::eAmdWave64, 64u, 512u, 512u, 120u},
+    {LaunchPlatform::eAmdWave32, 32u, 512u, 512u, 120u},
+    {LaunchPlatform::eMetal,     32u, 256u, 256u,  32u},
+}};
+// clang-format on
+
+// true if the architecture executes wave64 (gfx8 and gfx9), false for wave32 (gfx10 and newer) and for the target
+// feature entries of the list (e.g., "xnack-")
+constexpr bool IsWave64Arch(std::string_view arch) {
+    return arch.size() == 6u && arch.substr(0u, 3u) == "gfx" && (arch[3] == '8' || arch[3] == '9');
+}
+
+// true if any architecture of the list executes wave64
+constexpr bool HasWave64Arch(std::string_view list) {
+    for (size_t i = 0; i < ArchCount(list); ++i) {
+        if (IsWave64Arch(ArchAt(list, i))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+constexpr const LaunchTuning& GetLaunchTuning(LaunchPlatform platform) {
+    for (const auto& tuning : g_launch_tunings) {
+        if (tuning.platform == platform) {
+            return tuning;
+        }
+    }
+    return g_launch_tunings[0];
+}
+
+// The tuning of the platform the module is built for. For AMD the device code is shared by all architectures
+// of the list, so wave64 is used as soon as one of them needs it (multiples of 64 are also fine for wave32).
+#if defined(GPU_AUDIO_NV)
+inline constexpr const LaunchTuning& g_launch_tuning {GetLaunchTuning(LaunchPlatform::eNvidia)};
+#elif defined(GPU_AUDIO_AMD)
+inline constexpr const LaunchTuning& g_launch_tuning {GetLaunchTuning(HasWave64Arch(g_arch_list) ? LaunchPlatform::eAmdWave64 : LaunchPlatform::eAmdWave32)};
+#elif defined(GPU_AUDIO_MAC)
+inline constexpr const LaunchTuning& g_launch_tuning {GetLaunchTuning(LaunchPlatform::eMetal)};
+#else
+#error "LaunchTuning.h: one of GPU_AUDIO_NV, GPU_AUDIO_AMD or GPU_AUDIO_MAC must be defined"
+#endif
+
+// number of threads per block for `block_count` blocks (channels) of `buffer_size` samples each
+constexpr uint32_t SelectThreadCount(const LaunchTuning& tuning, uint32_t block_count, uint32_t buffer_size) {
+    // one thread per sample, rounded up to whole wavefronts
+    const uint32_t rounded = (buffer_size + tuning.wavefront_size - 1u) / tuning.wavefront_size * tuning.wavefront_size;
+    const uint32_t limit = block_count >= tuning.saturating_block_count ? tuning.preferred_block_size : tuning.max_block_size;
+    return std::min(limit, rounded);
+}
+
+} // namespace gain
+
+#endif // GAIN_LAUNCH_TUNING_H
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_SLAB_POOL_H
+#define GAIN_SLAB_POOL_H
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Fixed-size object pool. Memory is requested from the heap in slabs of `SlotsPerSlab` objects and never
+// returned before the pool is destroyed; freed slots are kept in a free list and handed out again (last freed first,
+// which is likely still in cache). Creating and destroying many objects of the same type thus neither fragments
+// the heap nor costs a heap allocation once the pool has grown to the peak number of objects.
+// The pool only provides storage; objects are constructed with placement new and destroyed explicitly. It tracks
+// which slots are handed out, so a slot is never returned twice.
+template <class T, uint32_t SlotsPerSlab>
+class SlabPool {
+public:
+    struct Stats {
+        // number of slabs requested from the heap
+        uint32_t slab_count;
+        // number of slots in all slabs
+        uint32_t capacity;
+        // slots currently handed out
+        uint32_t in_use;
+        // highest number of slots handed out at once
+        uint32_t peak_in_use;
+        // number of successful Allocate calls over the pool's lifetime
+        uint64_t allocation_count;
+    };
+
+    SlabPool() = default;
+    // all objects must have been destroyed and their slots deallocated
+    ~SlabPool() = default;
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    // storage for one T; nullptr if the pool is exhausted and a new slab can not be allocated
+    void* Allocate() noexcept {
+        std::lock_guard<std::mutex> lock {m_mutex};
+        if (m_free == nullptr && !AddSlab()) {
+            return nullptr;
+        }
+        Slot* slot = m_free;
+        m_free = slot->next;
+        size_t slab {0u};
+        uint32_t index {0u};
+        FindSlot(slot, slab, index);
+        m_slabs[slab].live[index] = true;
+        ++m_stats.in_use;
+        ++m_stats.allocation_count;
+        m_stats.peak_in_use = std::max(m_stats.peak_in_use, m_stats.in_use);
+        return slot->storage;
+    }
+
+    // returns the storage of an object from this pool; the object must have been destroyed already. Returns false
+    // and ignores `memory` unless it is a slot that is handed out, e.g., if it has already been deallocated
+    bool Deallocate(void* memory) noexcept {
+        std::lock_guard<std::mutex> lock {m_mutex};
+        Slot* slot = static_cast<Slot*>(memory);
+        if (!Retire(slot)) {
+            return false;
+        }
+        Free(slot);
+        return true;
+    }
+
+    // destroys the T at `memory` with `destroy(T*)` and returns its storage, with a single lookup of the slot. Returns
+    // false and does not call `destroy` unless `memory` is a slot that is handed out; of two concurrent calls for the
+    // same slot, only one destroys it. `destroy` runs outside the pool's lock
+    template <class Fn>
+    bool Destroy(void* memory, Fn&& destroy) noexcept {
+        Slot* slot = static_cast<Slot*>(memory);
+        {
+            std::lock_guard<std::mutex> lock {m_mutex};
+            if (!Retire(slot)) {
+                return false;
+            }
+        }
+        // the slot is neither live nor free, so no other call can reach it
+        destroy(reinterpret_cast<T*>(slot->storage));
+        std::lock_guard<std::mutex> lock {m_mutex};
+        Free(slot);
+        return true;
+    }
+
+    // true if `memory` is a slot of this pool that is handed out, i.e., not yet deallocated
+    bool Owns(const void* memory) const noexcept {
+        std::lock_guard<std::mutex> lock {m_mutex};
+        size_t slab {0u};
+        uint32_t index {0u};
+        return FindSlot(static_cast<const Slot*>(memory), slab, index) && m_slabs[slab].live[index];
+    }
+
+    Stats GetStats() const noexcept {
+        std::lock_guard<std::mutex> lock {m_mutex};
+        return m_stats;
+    }
+
+private:
+    // a slot holds either an object or, while free, the link to the next free slot
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct Slab {
+        std::unique_ptr<Slot[]> slots;
+        // slots that are handed out
+        std::bitset<SlotsPerSlab> live;
+    };
+
+    // finds the slab of `slot` and the slot's index in it; false if `slot` is not the address of a slot of the pool.
+    // The slabs are sorted by address, so this is a binary search over them
+    bool FindSlot(const Slot* slot, size_t& slab_index, uint32_t& slot_index) const noexcept {
+        const auto address = reinterpret_cast<uintptr_t>(slot);
+        // the first slab that starts after `slot`; the slot can only be in the one before it
+        const auto next = std::upper_bound(m_slabs.begin(), m_slabs.end(), address,
+            [](uintptr_t value, const Slab& slab) { return value < reinterpret_cast<uintptr_t>(slab.slots.get()); });
+        if (next == m_slabs.begin()) {
+            return false;
+        }
+        const auto begin = reinterpret_cast<uintptr_t>(std::prev(next)->slots.get());
+        const uintptr_t offset = address - begin;
+        if (offset >= SlotsPerSlab * sizeof(Slot) || offset % sizeof(Slot) != 0u) {
+            return false;
+        }
+        slab_index = static_cast<size_t>(std::distance(m_slabs.begin(), next)) - 1u;
+        slot_index = static_cast<uint32_t>(offset / sizeof(Slot));
+        return true;
+    }
+
+    // marks a live slot as no longer handed out; false (and no change) unless `slot` is live
+    bool Retire(const Slot* slot) noexcept {
+        size_t slab {0u};
+        uint32_t index {0u};
+        if (!FindSlot(slot, slab, index) || !m_slabs[slab].live[index]) {
+            return false;
+        }
+        m_slabs[slab].live[index] = false;
+        return true;
+    }
+
+    // puts a retired slot on the free list
+    void Free(Slot* slot) noexcept {
+        slot->next = m_free;
+        m_free = slot;
+        --m_stats.in_use;
+    }
+
+    bool AddSlab() noexcept {
+        std::unique_ptr<Slot[]> slab {new (std::nothrow) Slot[SlotsPerSlab]};
+        if (!slab) {
+            return false;
+        }
+        // keep the slabs sorted by address for FindSlot
+        Slot* slots = slab.get();
+        const auto position = std::upper_bound(m_slabs.begin(), m_slabs.end(), slots,
+            [](const Slot* value, const Slab& other) { return std::less<const Slot*> {}(value, other.slots.get()); });
+        try {
+            m_slabs.insert(position, Slab {std::move(slab), {}});
+        }
+        catch (...) {
+            return false;
+        }
+        // chain the new slots in order, so consecutive allocations are adjacent in memory
+        for (uint32_t i = 0; i + 1u < SlotsPerSlab; ++i) {
+            slots[i].next = &slots[i + 1u];
+        }
+        slots[SlotsPerSlab - 1u].next = m_free;
+        m_free = slots;
+        ++m_stats.slab_count;
+        m_stats.capacity += SlotsPerSlab;
+        return true;
+    }
+
+    mutable std::mutex m_mutex;
+    std::vector<Slab> m_slabs;
+    Slot* m_free {nullptr};
+    Stats m_stats {};
+};
+
+#endif // GAIN_SLAB_POOL_H
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "Trace.h"
+
+#if defined(GAIN_TRACE)
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(WIN32)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#include <unistd.h>
+#else
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace gain::trace {
+namespace {
+
+uint64_t CurrentThreadId() noexcept {
+#if defined(WIN32)
+    return GetCurrentThreadId();
+#elif defined(__APPLE__)
+    uint64_t id {0u};
+    pthread_threadid_np(nullptr, &id);
+    return id;
+#else
+    return static_cast<uint64_t>(syscall(SYS_gettid));
+#endif
+}
+
+uint64_t CurrentProcessId() noexcept {
+#if defined(WIN32)
+    return GetCurrentProcessId();
+#else
+    return static_cast<uint64_t>(getpid());
+#endif
+}
+
+// how often the flush thread drains the rings; a ring holds EventRing::Capacity events, far more than a thread
+// records in this time
+constexpr std::chrono::milliseconds g_flush_interval {100};
+
+// ring of the calling thread, see Tracer::Register. Rings stay registered until the library is unloaded, so threads
+// keep their pointer across sessions. Trivially destructible, so Record never registers a thread exit handler
+thread_local EventRing* t_ring {nullptr};
+
+// releases the ring of a thread when it exits; only touched in Register
+struct RingOwner {
+    ~RingOwner() {
+        if (ring != nullptr) {
+            ring->released.store(true, std::memory_order_release);
+        }
+    }
+
+    EventRing* ring {nullptr};
+};
+
+thread_local RingOwner t_ring_owner;
+
+enum class SessionState : uint32_t {
+    eInactive,
+    eActive,
+    // End stopped recording and waits for the final flush; events that end now are dropped
+    eEnding
+};
+
+class Tracer {
+public:
+    void Begin() noexcept {
+        std::lock_guard<std::mutex> lock {m_session_mutex};
+        if (m_sessions++ > 0u) {
+            return;
+        }
+        const char* path = std::getenv("GAIN_TRACE_FILE");
+        m_file = std::fopen(path != nullptr ? path : "gain_trace.json", "w");
+        if (m_file == nullptr) {
+            return;
+        }
+        std::fputs("{\"traceEvents\":[\n", m_file);
+        m_pid = CurrentProcessId();
+        m_event_count = 0u;
+        m_dropped_before = CountDropped();
+        m_rejected.store(0u, std::memory_order_relaxed);
+        // events recorded after the previous session ended belong to no trace
+        Flush(false);
+        try {
+            m_stop = false;
+            m_flush_thread = std::thread {[this] { Run(); }};
+        }
+        catch (...) {
+            std::fclose(m_file);
+            m_file = nullptr;
+            return;
+        }
+        m_state.store(SessionState::eActive);
+    }
+
+    void End() noexcept {
+        std::lock_guard<std::mutex> lock {m_session_mutex};
+        if (m_sessions == 0u || --m_sessions > 0u || m_file == nullptr) {
+            return;
+        }
+        m_state.store(SessionState::eEnding);
+        {
+            std::lock_guard<std::mutex> stop_lock {m_stop_mutex};
+            m_stop = true;
+        }
+        m_stop_signal.notify_one();
+        m_flush_thread.join();
+        // threads that saw the session active finish their push without blocking; after this, the final flush
+        // gets every event that was recorded. No ring is added meanwhile, and new rings have never been recording
+        {
+            std::lock_guard<std::mutex> rings_lock {m_rings_mutex};
+            for (const auto& ring : m_rings) {
+                while (ring->recording.load() != 0u) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        Flush(true);
+        const uint64_t dropped = CountDropped() - m_dropped_before + m_rejected.load(std::memory_order_relaxed);
+        std::fprintf(m_file, "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":\"%llu\"}}\n",
+            static_cast<unsigned long long>(dropped));
+        std::fclose(m_file);
+        m_file = nullptr;
+        m_state.store(SessionState::eInactive);
+    }
+
+    void Register() noexcept {
+        if (t_ring != nullptr) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock {m_rings_mutex};
+        // the ring of a thread that exited, once its events are written, so the rings do not grow with thread churn
+        for (const auto& ring : m_rings) {
+            if (ring->released.load(std::memory_order_acquire) && ring->IsEmpty()) {
+                ring->released.store(false, std::memory_order_relaxed);
+                Assign(*ring);
+                return;
+            }
+        }
+        std::unique_ptr<EventRing> ring {new (std::nothrow) EventRing {}};
+        if (!ring) {
+            return;
+        }
+        try {
+            m_rings.push_back(std::move(ring));
+        }
+        catch (...) {
+            return;
+        }
+        Assign(*m_rings.back());
+    }
+
+    void Record(const Event& event) noexcept {
+        EventRing* ring = t_ring;
+        if (ring == nullptr) {
+            // the thread never registered
+            if (m_state.load(std::memory_order_relaxed) == SessionState::eActive) {
+                m_rejected.fetch_add(1u, std::memory_order_relaxed);
+            }
+            return;
+        }
+        // announce the push in the thread's own ring before looking at the state, so that End either sees it or
+        // this thread sees eEnding (both are sequentially consistent). Only this thread writes the flag, so
+        // recording threads never contend for a cache line
+        ring->recording.store(1u);
+        const SessionState state = m_state.load();
+        if (state == SessionState::eActive) {
+            ring->Push(event);
+        }
+        else if (state == SessionState::eEnding) {
+            m_rejected.fetch_add(1u, std::memory_order_relaxed);
+        }
+        ring->recording.store(0u, std::memory_order_release);
+    }
+
+private:
+    // makes `ring` the ring of the calling thread; called with m_rings_mutex held
+    void Assign(EventRing& ring) noexcept {
+        ring.thread_id = CurrentThreadId();
+        t_ring = &ring;
+        t_ring_owner.ring = &ring;
+    }
+
+    void Run() noexcept {
+        std::unique_lock<std::mutex> lock {m_stop_mutex};
+        while (!m_stop_signal.wait_for(lock, g_flush_interval, [this] { return m_stop; })) {
+            lock.unlock();
+            Flush(true);
+            lock.lock();
+        }
+    }
+
+    // drains all rings; writes the events to the trace file if `write` is set
+    void Flush(bool write) noexcept {
+        std::lock_guard<std::mutex> lock {m_rings_mutex};
+        for (const auto& ring : m_rings) {
+            ring->Drain([&](const Event& event) {
+                if (!write) {
+                    return;
+                }
+                // Chrome trace timestamps are microseconds
+                std::fprintf(m_file, "%s{\"name\":\"%s\",\"cat\":\"gain\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%llu,\"tid\":%llu}",
+                    m_event_count++ > 0u ? ",\n" : "", event.name, static_cast<double>(event.begin_ns) * 1e-3,
+                    static_cast<double>(event.duration_ns) * 1e-3, static_cast<unsigned long long>(m_pid),
+                    static_cast<unsigned long long>(ring->thread_id));
+            });
+        }
+        if (write) {
+            std::fflush(m_file);
+        }
+    }
+
+    uint64_t CountDropped() noexcept {
+        std::lock_guard<std::mutex> lock {m_rings_mutex};
+        uint64_t dropped {0u};
+        for (const auto& ring : m_rings) {
+            dropped += ring->GetDropped();
+        }
+        return dropped;
+    }
+
+    std::atomic<SessionState> m_state {SessionState::eInactive};
+    // events of the session that no ring took
+    std::atomic<uint64_t> m_rejected {0u};
+
+    // guards the session count and the trace file setup
+    std::mutex m_session_mutex;
+    uint32_t m_sessions {0u};
+    std::FILE* m_file {nullptr};
+    uint64_t m_pid {0u};
+    uint64_t m_event_count {0u};
+    uint64_t m_dropped_before {0u};
+
+    // guards the ring registry; recording threads only take it in Register. Rings are never freed before the
+    // library is unloaded, as exited threads' rings are reused instead
+    std::mutex m_rings_mutex;
+    std::vector<std::unique_ptr<EventRing>> m_rings;
+
+    std::mutex m_stop_mutex;
+    std::condition_variable m_stop_signal;
+    bool m_stop {false};
+    std::thread m_flush_thread;
+};
+
+Tracer& GetTracer() noexcept {
+    static Tracer tracer;
+    return tracer;
+}
+
+} // namespace
+
+void BeginSession() noexcept {
+    GetTracer().Register();
+    GetTracer().Begin();
+}
+
+void EndSession() noexcept {
+    GetTracer().End();
+}
+
+void RegisterThread() noexcept {
+    GetTracer().Register();
+}
+
+void Record(const Event& event) noexcept {
+    GetTracer().Record(event);
+}
+
+} // namespace gain::trace
+
+#endif // GAIN_TRACE
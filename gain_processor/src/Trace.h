@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_TRACE_H
+#define GAIN_TRACE_H
+
+// Optional tracing of the processor lifecycle in the Chrome trace event format (chrome://tracing, ui.perfetto.dev).
+// Only compiled in with `GAIN_TRACE` defined (CMake option GAIN_TRACE); otherwise the macros below expand to nothing.
+//
+// Every thread records complete events ("ph": "X") into its own single-producer/single-consumer ring buffer, so
+// recording neither locks nor allocates, and threads only write to their own ring. The ring is taken when the thread
+// registers (GAIN_TRACE_REGISTER_THREAD), which the module does from its non-real-time hooks only: the session begin
+// and GainProcessor::OnBlueprintRebuild. The ring of a thread that exits is reused by the next thread that registers.
+// A background thread drains the rings and appends the events to the trace file, given by the environment variable
+// GAIN_TRACE_FILE (default: gain_trace.json in the working directory). Events that do not fit into a full ring, that
+// come from a thread that never registered or that end while the session ends are dropped and counted; the count is
+// written into the trace metadata.
+// Timestamps come from std::chrono::steady_clock (CLOCK_MONOTONIC on Linux, the clock of Perfetto and Chrome), and
+// pid/tid are the ones of the OS, so the events line up with traces of the engine in the same process.
+
+#if defined(GAIN_TRACE)
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace gain::trace {
+
+// name must be a string literal (or have static storage duration); only the pointer is recorded
+struct Event {
+    const char* name;
+    uint64_t begin_ns;
+    uint64_t duration_ns;
+};
+
+// Events of one thread. Written by the owning thread only, read by the flush thread only
+class EventRing {
+public:
+    static constexpr uint32_t Capacity {4096u};
+
+    bool Push(const Event& event) noexcept {
+        const uint32_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) >= Capacity) {
+            m_dropped.fetch_add(1u, std::memory_order_relaxed);
+            return false;
+        }
+        m_events[head % Capacity] = event;
+        m_head.store(head + 1u, std::memory_order_release);
+        return true;
+    }
+
+    // calls `fn` for all recorded events and releases their slots
+    template <class Fn>
+    void Drain(Fn&& fn) noexcept {
+        const uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        const uint32_t head = m_head.load(std::memory_order_acquire);
+        for (uint32_t i = tail; i != head; ++i) {
+            fn(m_events[i % Capacity]);
+        }
+        m_tail.store(head, std::memory_order_release);
+    }
+
+    uint64_t GetDropped() const noexcept { return m_dropped.load(std::memory_order_relaxed); }
+
+    // true if the flush thread took every event
+    bool IsEmpty() const noexcept { return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire); }
+
+    // OS id of the owning thread
+    uint64_t thread_id {0u};
+    // 1 while the owning thread is in Record, so the session end can wait for its push (see Tracer::Record)
+    std::atomic<uint32_t> recording {0u};
+    // set when the owning thread exits; the next thread that registers takes the ring over once it is drained
+    std::atomic<bool> released {false};
+
+private:
+    alignas(64) std::atomic<uint32_t> m_head {0u};
+    alignas(64) std::atomic<uint32_t> m_tail {0u};
+    std::atomic<uint64_t> m_dropped {0u};
+    Event m_events[Capacity];
+};
+
+// Starts the flush thread with the first session; the last session to end flushes the remaining events and
+// completes the trace file. Sessions are reference counted (one per module instance)
+void BeginSession() noexcept;
+void EndSession() noexcept;
+
+// registers a ring for the calling thread, if it has none yet: a released one or a new one. Locks and may allocate
+// the first time, so it is only called from hooks that are not real-time
+void RegisterThread() noexcept;
+
+// records an event of the calling thread into its ring during a session
+void Record(const Event& event) noexcept;
+
+inline uint64_t Now() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// records the lifetime of the scope as one event
+class Scope {
+public:
+    explicit Scope(const char* name) noexcept :
+        m_name {name},
+        m_begin {Now()} {}
+
+    ~Scope() {
+        Record({m_name, m_begin, Now() - m_begin});
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* m_name;
+    uint64_t m_begin;
+};
+
+} // namespace gain::trace
+
+#define GAIN_TRACE_CONCAT_IMPL(a, b) a##b
+#define GAIN_TRACE_CONCAT(a, b) GAIN_TRACE_CONCAT_IMPL(a, b)
+#define GAIN_TRACE_SCOPE(name) const gain::trace::Scope GAIN_TRACE_CONCAT(gain_trace_scope_, __LINE__) {name}
+#define GAIN_TRACE_BEGIN_SESSION() gain::trace::BeginSession()
+#define GAIN_TRACE_END_SESSION() gain::trace::EndSession()
+#define GAIN_TRACE_REGISTER_THREAD() gain::trace::RegisterThread()
+
+#else
+
+#define GAIN_TRACE_SCOPE(name) static_cast<void>(0)
+#define GAIN_TRACE_BEGIN_SESSION() static_cast<void>(0)
+#define GAIN_TRACE_END_SESSION() static_cast<void>(0)
+#define GAIN_TRACE_REGISTER_THREAD() static_cast<void>(0)
+
+#endif // GAIN_TRACE
+
+#endif // GAIN_TRACE_H
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_DEVICE_UTILITIES_CUH
+#define GAIN_DEVICE_UTILITIES_CUH
+
+#if defined(GAIN_HOST_EMULATION)
+#include <cmath>
+#endif
+
+namespace gain {
+
+// largest and smallest normal float; device code can not rely on <cfloat> on every platform
+constexpr float g_float_max {3.40282347e+38f};
+constexpr float g_float_min_normal {1.17549435e-38f};
+
+__device_fct inline float Exp2(float x) {
+#if defined(GAIN_HOST_EMULATION)
+    return std::exp2(x);
+#elif defined(GPU_AUDIO_MAC)
+    return metal::exp2(x);
+#else
+    return exp2f(x);
+#endif
+}
+
+__device_fct inline float Log2(float x) {
+#if defined(GAIN_HOST_EMULATION)
+    return std::log2(x);
+#elif defined(GPU_AUDIO_MAC)
+    return metal::log2(x);
+#else
+    return log2f(x);
+#endif
+}
+
+struct SumOp {
+    template <typename T>
+    __device_fct T operator()(T a, T b) const { return a + b; }
+};
+
+struct MaxOp {
+    template <typename T>
+    __device_fct T operator()(T a, T b) const { return a < b ? b : a; }
+};
+
+struct MinOp {
+    template <typename T>
+    __device_fct T operator()(T a, T b) const { return b < a ? b : a; }
+};
+
+// Block-wide reduction of one value per thread. `smem` must hold `context.blockDim()` values.
+// All threads of the block must call it; all of them get the result.
+// Works for any block size, not only powers of two.
+template <typename T, class Op, class Context>
+__device_fct T BlockReduce(Context& context, __device_addr T* smem, T value, Op op) {
+    const uint32_t t = context.threadId();
+    smem[t] = value;
+    context.synchronize();
+    for (uint32_t active = context.blockDim(); active > 1u;) {
+        const uint32_t half = (active + 1u) / 2u;
+        if (t < active - half) {
+            smem[t] = op(smem[t], smem[t + half]);
+        }
+        context.synchronize();
+        active = half;
+    }
+    const T result = smem[0];
+    // make sure nobody overwrites smem[0] before all threads have read it
+    context.synchronize();
+    return result;
+}
+
+// Block-wide sliding window: window[i] = op(v[i], v[i + 1], ..., v[i + width - 1]) for i < count.
+// `level` holds the count + width - 1 values v and is overwritten, as is `spare` (same size).
+// Combines power-of-two windows in log2(width) steps, so it works for any associative `op`.
+// All threads of the block must call it; `level` must be visible to all threads (synchronize before).
+template <typename T, class Op, class Context>
+__device_fct void BlockSlidingWindow(Context& context, __device_addr T* level, __device_addr T* spare, __device_addr T* window,
+    uint32_t count, uint32_t width, Op op) {
+    const uint32_t t = context.threadId();
+    const uint32_t threads = context.blockDim();
+    // part [i, i + offset) of the window that is already combined into window[i]
+    uint32_t offset = 0u;
+    // level[i] combines v[i, i + w) for all i < count + width - w
+    for (uint32_t w = 1u; offset < width; w *= 2u) {
+        if (width & w) {
+            for (uint32_t i = t; i < count; i += threads) {
+                window[i] = offset == 0u ? level[i] : op(window[i], level[i + offset]);
+            }
+            offset += w;
+        }
+        if (offset < width) {
+            const uint32_t next_count = count + width - 2u * w;
+            for (uint32_t i = t; i < next_count; i += threads) {
+                spare[i] = op(level[i], level[i + w]);
+            }
+            context.synchronize();
+            __device_addr T* swap = level;
+            level = spare;
+            spare = swap;
+        }
+    }
+    context.synchronize();
+}
+
+// Block-wide inclusive scan: values[i] = op(values[0], ..., values[i]) for i < count. `spare` must hold `count`
+// values. Returns the array holding the result, which is either `values` or `spare`.
+// All threads of the block must call it; `values` must be visible to all threads (synchronize before).
+template <typename T, class Op, class Context>
+__device_fct __device_addr T* BlockInclusiveScan(Context& context, __device_addr T* values, __device_addr T* spare, uint32_t count, Op op) {
+    const uint32_t t = context.threadId();
+    const uint32_t threads = context.blockDim();
+    for (uint32_t d = 1u; d < count; d *= 2u) {
+        for (uint32_t i = t; i < count; i += threads) {
+            spare[i] = i >= d ? op(values[i - d], values[i]) : values[i];
+        }
+        context.synchronize();
+        __device_addr T* swap = values;
+        values = spare;
+        spare = swap;
+    }
+    return values;
+}
+
+} // namespace gain
+
+#endif // GAIN_DEVICE_UTILITIES_CUH
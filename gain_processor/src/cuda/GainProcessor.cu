@@ -20,4 +20,8 @@
 //    - the number of tasks (must match the increasing integer from DeclareProcessorStep)
 
 DeclareProcessorStep(GainProcessorDevice<float>, 0, process, float, gain::ProcessorParameter, gain::TaskParameter);
-DeclareProcessor(GainProcessorDevice<float>, 1);
+DeclareProcessorStep(GainProcessorDevice<float>, 1, process_sanitized, float, gain::ProcessorParameter, gain::TaskParameter);
+DeclareProcessorStep(GainProcessorDevice<float>, 2, process_limited, float, gain::ProcessorParameter, gain::TaskParameter);
+DeclareProcessorStep(GainProcessorDevice<float>, 3, process_pair, float, gain::ProcessorParameter, gain::TaskParameter);
+DeclareProcessorStep(GainProcessorDevice<float>, 4, process_saturated, float, gain::ProcessorParameter, gain::TaskParameter);
+DeclareProcessor(GainProcessorDevice<float>, 5);
@@ -9,7 +9,15 @@
 
 #include "Properties.h"
 
+// the host emulation (see emulation/HostEmulation.h) compiles this processor as plain C++
+#if defined(GAIN_HOST_EMULATION)
+#include "HostEmulation.h"
+#else
 #include <platform/Abstraction.h>
+#endif
+
+#include "DeviceUtilities.cuh"
+#include "OversamplingFilter.cuh"
 
 template <typename TSample>
 class GainProcessorDevice {
@@ -25,6 +33,8 @@ public:
     // mandatory init function; can be used to initialize processor data members
     template <class Context>
     __device_fct void init(Context context, unsigned int max_buffer_length) __device_addr {
+        // nothing to do: the processor object has no members. The per-channel state of the stateful tasks lives in an
+        // output port sized for the channel count (see `begin_channel`)
     }
 
     // Every task of the processor must match the following interface:
@@ -68,6 +78,362 @@ public:
 
     template <class Context>
     __device_fct void process(Context context, __device_addr gain::ProcessorParameter* processor_param, __device_addr gain::TaskParameter* task_param,
+        __device_addr float* __device_addr* input, __device_addr float* __device_addr* output) __device_addr {
+        apply_gain<false>(context, processor_param, input, output);
+    }
+
+    // Same as `process`, but flushes subnormal samples to zero and replaces NaN/Inf with zero.
+    // The number of sanitized samples of each channel is written to output[1][channel] (the counter port, see
+    // GainProcessor::GainProcessor). Requires `blockDim()` uint32_t of shared memory for the count reduction.
+    template <class Context>
+    __device_fct void process_sanitized(Context context, __device_addr gain::ProcessorParameter* processor_param, __device_addr gain::TaskParameter* task_param,
+        __device_addr float* __device_addr* input, __device_addr float* __device_addr* output) __device_addr {
+        apply_gain<true>(context, processor_param, input, output);
+    }
+
+    // Same as `process`, followed by a brickwall limiter with `limiter_lookahead` samples of look-ahead and latency.
+    // The gain reduction (in log2) needed by each sample is the ceiling over the maximum magnitude of the next
+    // `limiter_lookahead` + 1 samples (sliding window maximum), so the gain is down before a peak arrives. It
+    // releases by at most `limiter_release_step` per sample (a min-plus prefix scan) and is smoothed by a moving
+    // average over the look-ahead, which still keeps every sample below the ceiling. NaN/Inf and subnormal
+    // input is flushed to zero; the count is written to output[1] if `limiter_count_sanitized` is set.
+    // The channel's delay line and envelope carry over to the next call (see `begin_channel`).
+    // Requires (4 * (blockDim() + limiter_lookahead) + blockDim()) floats of shared memory (see GainLimiter).
+    template <class Context>
+    __device_fct void process_limited(Context context, __device_addr gain::ProcessorParameter* processor_param, __device_addr gain::TaskParameter* task_param,
+        __device_addr float* __device_addr* input, __device_addr float* __device_addr* output) __device_addr {
+        const uint32_t channel = context.blockId();
+        if (channel >= processor_param->channel_count) {
+            return;
+        }
+        // the delay line (`lookahead` samples), followed by the envelope of the samples before them
+        __device_addr TSample* state = begin_channel(context, processor_param, output);
+        const uint32_t t = context.threadId();
+        const uint32_t threads = context.blockDim();
+        const uint32_t lookahead = processor_param->limiter_lookahead;
+        __device_addr TSample* state_delay = state;
+        __device_addr TSample* state_envelope = state + lookahead;
+        const uint32_t length = processor_param->buffer_length;
+        __device_addr TSample const* channel_input = input[0] + channel * processor_param->buffer_capacity;
+        __device_addr TSample* channel_output = output[0] + channel * processor_param->buffer_capacity;
+
+        // shared memory, for a tile of up to `threads` output samples:
+        // - signal: the gained input of the tile and the look-ahead behind it
+        // - level, spare: work arrays of the sliding window and scan
+        // - envelope: the gain envelope of the look-ahead samples before the tile and of the tile
+        // - window: per output sample result of the sliding windows
+        __device_addr TSample* signal = reinterpret_cast<__device_addr TSample*>(context.smem());
+        __device_addr TSample* level = signal + threads + lookahead;
+        __device_addr TSample* spare = level + threads + lookahead;
+        __device_addr TSample* envelope = spare + threads + lookahead;
+        __device_addr TSample* window = envelope + threads + lookahead;
+
+        for (uint32_t i = t; i < lookahead; i += threads) {
+            envelope[i] = state_envelope[i];
+        }
+
+        // every input sample is counted once: when it becomes an output sample of a tile, or when it goes to the delay line
+        uint32_t sanitized = 0u;
+        uint32_t uncounted = 0u;
+        // the delayed input stream is the delay line followed by the buffer: sample m of it is output at m - lookahead
+        for (uint32_t tile = 0; tile < length; tile += threads) {
+            const uint32_t count = length - tile < threads ? length - tile : threads;
+
+            for (uint32_t i = t; i < count + lookahead; i += threads) {
+                const TSample sample = limiter_input(processor_param, state_delay, channel_input, tile + i, i < count ? sanitized : uncounted);
+                signal[i] = sample;
+                level[i] = sample < TSample(0) ? -sample : sample;
+            }
+            context.synchronize();
+
+            // gain reduction needed for the peak within the look-ahead of each sample
+            gain::BlockSlidingWindow(context, level, spare, window, count, lookahead + 1u, gain::MaxOp {});
+            // release: envelope[j] = min(0, needed[k] + (j - k) * release) over all k <= j, including the
+            // previous tile's last value. As a min-plus scan over needed[k] - k * release it is parallel.
+            const TSample release = processor_param->limiter_release_step;
+            const TSample previous = lookahead > 0u ? envelope[lookahead - 1u] : TSample(0);
+            for (uint32_t i = t; i < count; i += threads) {
+                const TSample peak = window[i];
+                const TSample needed = peak > TSample(0) ? processor_param->limiter_ceiling - gain::Log2(peak) : TSample(0);
+                level[i] = (needed < TSample(0) ? needed : TSample(0)) - static_cast<TSample>(i) * release;
+            }
+            context.synchronize();
+            __device_addr TSample* released = gain::BlockInclusiveScan(context, level, spare, count, gain::MinOp {});
+            for (uint32_t i = t; i < count; i += threads) {
+                const TSample from_previous = previous + release;
+                const TSample value = static_cast<TSample>(i) * release + (released[i] < from_previous ? released[i] : from_previous);
+                envelope[lookahead + i] = value < TSample(0) ? value : TSample(0);
+            }
+            context.synchronize();
+
+            // smooth the envelope over the look-ahead; every average that covers a peak only contains values
+            // at or below the peak's reduction, so the smoothed gain still keeps it below the ceiling
+            for (uint32_t i = t; i < count + lookahead; i += threads) {
+                level[i] = envelope[i];
+            }
+            context.synchronize();
+            gain::BlockSlidingWindow(context, level, spare, window, count, lookahead + 1u, gain::SumOp {});
+            const TSample scale = TSample(1) / static_cast<TSample>(lookahead + 1u);
+            for (uint32_t i = t; i < count; i += threads) {
+                TSample sample = signal[i] * gain::Exp2(window[i] * scale);
+                if (needs_sanitizing(sample)) {
+                    sample = TSample(0);
+                }
+                channel_output[tile + i] = sample;
+            }
+
+            // keep the envelope of the last `lookahead` samples for the next tile
+            for (uint32_t i = t; i < lookahead; i += threads) {
+                level[i] = envelope[count + i];
+            }
+            context.synchronize();
+            for (uint32_t i = t; i < lookahead; i += threads) {
+                envelope[i] = level[i];
+            }
+            context.synchronize();
+        }
+
+        // the last `lookahead` samples of the delayed input stream become the new delay line; they are staged
+        // in shared memory as they partially come from the current delay line
+        for (uint32_t i = t; i < lookahead; i += threads) {
+            level[i] = limiter_input(processor_param, state_delay, channel_input, length + i, sanitized);
+        }
+        context.synchronize();
+        for (uint32_t i = t; i < lookahead; i += threads) {
+            state_delay[i] = level[i];
+            state_envelope[i] = envelope[i];
+        }
+
+        if (processor_param->limiter_count_sanitized) {
+            context.synchronize();
+            auto smem = reinterpret_cast<__device_addr uint32_t*>(level);
+            const uint32_t channel_sanitized = gain::BlockReduce(context, smem, sanitized, gain::SumOp {});
+            if (t == 0u) {
+                reinterpret_cast<__device_addr uint32_t*>(output[1])[channel] = channel_sanitized;
+            }
+        }
+    }
+
+    // Same as `process`, followed by a saturating nonlinearity (`saturation`) that runs at `oversampling_ratio` times
+    // the sample rate. Each tile of up to `blockDim()` input samples is interpolated by a polyphase lowpass (thread i
+    // computes the R oversampled samples of input sample i from P input samples), saturated, and decimated by the
+    // same lowpass (thread i computes output sample i from R * P oversampled samples). The taps (see
+    // OversamplingFilter.cuh) and the tiles are staged in shared memory; both filter histories carry over to the next call (see `begin_channel`).
+    // Requires GainOversampler::GetSharedMemorySize bytes of shared memory.
+    template <class Context>
+    __device_fct void process_saturated(Context context, __device_addr gain::ProcessorParameter* processor_param, __device_addr gain::TaskParameter* task_param,
+        __device_addr float* __device_addr* input, __device_addr float* __device_addr* output) __device_addr {
+        const uint32_t channel = context.blockId();
+        if (channel >= processor_param->channel_count) {
+            return;
+        }
+        const uint32_t t = context.threadId();
+        const uint32_t threads = context.blockDim();
+        const uint32_t length = processor_param->buffer_length;
+        const uint32_t ratio = processor_param->oversampling_ratio;
+        const uint32_t phase_taps = processor_param->oversampling_taps_per_phase;
+        const uint32_t taps = ratio * phase_taps;
+        // the interpolator's history (the last P - 1 gained input samples), followed by the decimator's (the last
+        // R * P - 1 saturated samples at the oversampled rate); empty without oversampling
+        __device_addr TSample* state = begin_channel(context, processor_param, output);
+        __device_addr TSample* state_input = state;
+        __device_addr TSample* state_oversampled = state + phase_taps - 1u;
+        const uint32_t saturation = processor_param->saturation;
+        __device_addr TSample const* channel_input = input[0] + channel * processor_param->buffer_capacity;
+        __device_addr TSample* channel_output = output[0] + channel * processor_param->buffer_capacity;
+
+        // shared memory: the taps, the input tile after the interpolator's P - 1 history samples, the oversampled
+        // tile after the decimator's R * P - 1 history samples, and a staging area for the histories
+        __device_addr TSample* filter = reinterpret_cast<__device_addr TSample*>(context.smem());
+        __device_addr TSample* signal = filter + taps;
+        __device_addr TSample* oversampled = signal + phase_taps - 1u + threads;
+        __device_addr TSample* staging = oversampled + taps - 1u + ratio * threads;
+
+        for (uint32_t i = t; i < taps; i += threads) {
+            filter[i] = gain::OversamplingTap(ratio, i);
+        }
+        for (uint32_t i = t; i + 1u < phase_taps; i += threads) {
+            signal[i] = state_input[i];
+        }
+        for (uint32_t i = t; i + 1u < taps; i += threads) {
+            oversampled[i] = state_oversampled[i];
+        }
+
+        for (uint32_t tile = 0; tile < length; tile += threads) {
+            const uint32_t count = length - tile < threads ? length - tile : threads;
+            if (t < count) {
+                signal[phase_taps - 1u + t] = channel_input[tile + t] * gain_at(processor_param, tile + t);
+            }
+            context.synchronize();
+
+            // interpolate: oversampled sample R * i + p is the zero-stuffed input filtered by the taps p, p + R, ...
+            // (scaled by R, as zero-stuffing keeps only 1/R of the signal's energy in the passband), then saturate
+            if (t < count) {
+                for (uint32_t p = 0; p < ratio; ++p) {
+                    TSample sum = TSample(0);
+                    for (uint32_t k = 0; k < phase_taps; ++k) {
+                        sum += filter[p + ratio * k] * signal[phase_taps - 1u + t - k];
+                    }
+                    oversampled[taps - 1u + ratio * t + p] = saturate(saturation, sum * static_cast<TSample>(ratio));
+                }
+            }
+            context.synchronize();
+
+            // decimate: output sample i is the filtered oversampled signal at R * i
+            if (t < count) {
+                TSample sum = TSample(0);
+                for (uint32_t j = 0; j < taps; ++j) {
+                    sum += filter[j] * oversampled[taps - 1u + ratio * t - j];
+                }
+                channel_output[tile + t] = sum;
+            }
+
+            // the last samples of both tiles are the history of the next tile
+            for (uint32_t i = t; i + 1u < phase_taps; i += threads) {
+                staging[i] = signal[count + i];
+            }
+            context.synchronize();
+            for (uint32_t i = t; i + 1u < phase_taps; i += threads) {
+                signal[i] = staging[i];
+            }
+            context.synchronize();
+            for (uint32_t i = t; i + 1u < taps; i += threads) {
+                staging[i] = oversampled[ratio * count + i];
+            }
+            context.synchronize();
+            for (uint32_t i = t; i + 1u < taps; i += threads) {
+                oversampled[i] = staging[i];
+            }
+            context.synchronize();
+        }
+
+        for (uint32_t i = t; i + 1u < phase_taps; i += threads) {
+            state_input[i] = signal[i];
+        }
+        for (uint32_t i = t; i + 1u < taps; i += threads) {
+            state_oversampled[i] = oversampled[i];
+        }
+    }
+
+    // Processes channels 2k and 2k + 1 in block k: applies the 2x2 pair matrix (mid/side encode, gain and decode,
+    // or balance; see GainPair) and the gain. The pair's samples are loaded once and combined in registers.
+    // The matrix moves linearly from `pair_from` to `pair_to` over the buffer, reaching `pair_to` at the last sample.
+    template <class Context>
+    __device_fct void process_pair(Context context, __device_addr gain::ProcessorParameter* processor_param, __device_addr gain::TaskParameter* task_param,
+        __device_addr float* __device_addr* input, __device_addr float* __device_addr* output) __device_addr {
+        const uint32_t pair = context.blockId();
+        if (2u * pair + 1u >= processor_param->channel_count) {
+            return;
+        }
+        const uint32_t capacity = processor_param->buffer_capacity;
+        const uint32_t length = processor_param->buffer_length;
+        __device_addr TSample const* left_input = input[0] + 2u * pair * capacity;
+        __device_addr TSample const* right_input = left_input + capacity;
+        __device_addr TSample* left_output = output[0] + 2u * pair * capacity;
+        __device_addr TSample* right_output = left_output + capacity;
+
+        TSample from[4];
+        TSample delta[4];
+        for (uint32_t i = 0; i < 4u; ++i) {
+            from[i] = processor_param->pair_from[i];
+            delta[i] = processor_param->pair_to[i] - from[i];
+        }
+        const TSample scale = length > 0u ? TSample(1) / static_cast<TSample>(length) : TSample(0);
+
+        for (uint32_t s = context.threadId(); s < length; s += context.blockDim()) {
+            const TSample left = left_input[s];
+            const TSample right = right_input[s];
+            const TSample position = static_cast<TSample>(s + 1u) * scale;
+            const TSample gain = gain_at(processor_param, s);
+            left_output[s] = ((from[0] + delta[0] * position) * left + (from[1] + delta[1] * position) * right) * gain;
+            right_output[s] = ((from[2] + delta[2] * position) * left + (from[3] + delta[3] * position) * right) * gain;
+        }
+    }
+
+private:
+    // Returns the state of the block's channel, which carries over from one call to the next: `state_stride` floats
+    // in output port `state_port` (see GainTaskSettings::GetStateSize). The port is only created for processors
+    // that limit or oversample, so plain gain processors reserve no device memory for it. The state is reset to
+    // silence and no gain reduction if the host requests it (`reset_state`, set for the first launch and the first
+    // one after a channel layout change, which also resizes the port). Each channel's state is only touched by its
+    // own block, so no other block can observe the reset. All threads of the block must call it.
+    template <class Context>
+    __device_fct static __device_addr TSample* begin_channel(Context& context, __device_addr gain::ProcessorParameter* processor_param,
+        __device_addr float* __device_addr* output) {
+        const uint32_t stride = processor_param->state_stride;
+        __device_addr TSample* state = output[processor_param->state_port] + context.blockId() * stride;
+        if (processor_param->reset_state) {
+            for (uint32_t i = context.threadId(); i < stride; i += context.blockDim()) {
+                state[i] = TSample(0);
+            }
+            context.synchronize();
+        }
+        return state;
+    }
+
+    // the nonlinearity of process_saturated (GainConfig::Saturation)
+    __device_fct static TSample saturate(uint32_t saturation, TSample x) {
+        if (saturation == 1u) {
+            return x < TSample(-1) ? TSample(-1) : (x > TSample(1) ? TSample(1) : x);
+        }
+        if (saturation == 2u) {
+            // x - 4/27 x^3 up to |x| = 1.5, where it reaches 1 with zero slope
+            const TSample clamped = x < TSample(-1.5) ? TSample(-1.5) : (x > TSample(1.5) ? TSample(1.5) : x);
+            return clamped - TSample(4.0 / 27.0) * clamped * clamped * clamped;
+        }
+        return x;
+    }
+
+    // sample m of the limiter's delayed input stream: the delay line followed by the gained, sanitized input
+    __device_fct static TSample limiter_input(__device_addr gain::ProcessorParameter* processor_param, __device_addr TSample const* delay,
+        __device_addr TSample const* channel_input, uint32_t m, uint32_t& sanitized) {
+        const uint32_t lookahead = processor_param->limiter_lookahead;
+        if (m < lookahead) {
+            return delay[m];
+        }
+        const uint32_t s = m - lookahead;
+        return sanitized_gain(channel_input[s], gain_at(processor_param, s), sanitized);
+    }
+
+    // `sample` times `gain` with non-finite and subnormal input and products replaced by zero; a sample that needed
+    // sanitizing counts once, even if both its input and its product are flushed
+    __device_fct static TSample sanitized_gain(TSample sample, TSample gain, uint32_t& sanitized) {
+        // sanitize the input first so that subnormal input does not slow down the multiplication
+        const bool bad_input = needs_sanitizing(sample);
+        if (bad_input) {
+            sample = TSample(0);
+        }
+        sample *= gain;
+        // very small gains can produce subnormals (and huge gains Inf) from valid input
+        if (needs_sanitizing(sample)) {
+            sample = TSample(0);
+            ++sanitized;
+        }
+        else if (bad_input) {
+            ++sanitized;
+        }
+        return sample;
+    }
+
+    // gain of sample `s`, following the ramp of the processor parameter
+    __device_fct static TSample gain_at(__device_addr gain::ProcessorParameter* processor_param, uint32_t s) {
+        if (s >= processor_param->ramp_length) {
+            return processor_param->gain;
+        }
+        const float value = processor_param->ramp_start + static_cast<float>(s) * processor_param->ramp_step;
+        return processor_param->ramp_in_log2 ? gain::Exp2(value) : value;
+    }
+
+    // returns true if `x` is NaN, +-Inf or subnormal, i.e., if it must be replaced by zero
+    __device_fct static bool needs_sanitizing(TSample x) {
+        const TSample magnitude = x < TSample(0) ? -x : x;
+        // NaN fails every comparison, Inf fails the upper bound
+        return !(magnitude <= gain::g_float_max) || (magnitude < gain::g_float_min_normal && magnitude != TSample(0));
+    }
+
+    // `Sanitize` is a compile-time switch: for `false` the checks and the counter reduction are not generated at all
+    template <bool Sanitize, class Context>
+    __device_fct void apply_gain(Context& context, __device_addr gain::ProcessorParameter* processor_param,
         __device_addr float* __device_addr* input, __device_addr float* __device_addr* output) __device_addr {
         // sanity check, that not more blocks enter than we have channels. If host code is correct, i.e.,
         // GainProcessor::m_gpu_task::block_count == GainProcessor::m_input_port->m_channel_count, this is obsolete.
@@ -78,10 +444,27 @@ public:
             __device_addr TSample const* channel_input = input[0] + channel_offset;
             // pointer to the first output sample in the block's channel
             __device_addr TSample* channel_output = output[0] + channel_offset;
+            // number of samples this thread had to sanitize
+            uint32_t sanitized = 0u;
             // iterate over the buffer_length <= buffer_capacity samples of the block's channel; one thread per sample
             for (uint32_t s = context.threadId(); s < processor_param->buffer_length; s += context.blockDim()) {
-                // apply the gain and write to output
-                channel_output[s] = channel_input[s] * processor_param->gain;
+                TSample sample = channel_input[s];
+                if (Sanitize) {
+                    sample = sanitized_gain(sample, gain_at(processor_param, s), sanitized);
+                }
+                else {
+                    sample *= gain_at(processor_param, s);
+                }
+                // write to output
+                channel_output[s] = sample;
+            }
+            if (Sanitize) {
+                // sum up the counts of all threads and publish the channel's count
+                auto smem = reinterpret_cast<__device_addr uint32_t*>(context.smem());
+                const uint32_t channel_sanitized = gain::BlockReduce(context, smem, sanitized, gain::SumOp {});
+                if (context.threadId() == 0u) {
+                    reinterpret_cast<__device_addr uint32_t*>(output[1])[context.blockId()] = channel_sanitized;
+                }
             }
         }
     }
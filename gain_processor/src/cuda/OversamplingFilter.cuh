@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_OVERSAMPLING_FILTER_CUH
+#define GAIN_OVERSAMPLING_FILTER_CUH
+
+#include "Properties.h"
+
+namespace gain {
+
+// The anti-imaging/anti-aliasing lowpass of process_saturated (see GainOversampler), compiled into the device code so
+// that no launch has to carry it in its gain::ProcessorParameter.
+//
+// A Kaiser-windowed sinc (beta 8.5) with R * (P - 1) + 1 taps at the oversampled rate (R: ratio, P: taps per polyphase
+// branch, gain::g_oversampling_taps_per_phase), cutoff at the Nyquist frequency of the input and unity gain at DC,
+// zero-padded to R * P taps; the taps at multiples of R from the center are exactly zero. Relative to the Nyquist
+// frequency of the input, it attenuates by at least 80 dB from 1.36 on and is flat within 0.1 dB up to 0.73. So the
+// harmonics of the saturation that alias into the band below 0.64 (15 kHz at 48 kHz) are 80 dB down; the transition
+// band in between is what P = 16 taps per phase allow at that rejection. Tap i of the filter for `ratio`; without
+// oversampling the filter is a single unit tap.
+__device_fct inline float OversamplingTap(uint32_t ratio, uint32_t i) {
+    constexpr float taps_2x[2u * g_oversampling_taps_per_phase] {
+        -3.106171425e-05f, 0.0f, 4.991114256e-04f, 0.0f,
+        -2.328485949e-03f, 0.0f, 7.254782133e-03f, 0.0f,
+        -1.814525016e-02f, 0.0f, 4.036310688e-02f, 0.0f,
+        -9.030652046e-02f, 0.0f, 3.126999438e-01f, 4.999887347e-01f,
+        3.126999438e-01f, 0.0f, -9.030652046e-02f, 0.0f,
+        4.036310688e-02f, 0.0f, -1.814525016e-02f, 0.0f,
+        7.254782133e-03f, 0.0f, -2.328485949e-03f, 0.0f,
+        4.991114256e-04f, 0.0f, -3.106171425e-05f, 0.0f,
+    };
+    constexpr float taps_4x[4u * g_oversampling_taps_per_phase] {
+        -1.553078619e-05f, -2.935940392e-05f, 0.0f, 1.070903454e-04f,
+        2.495545777e-04f, 2.745267120e-04f, 0.0f, -5.884715938e-04f,
+        -1.164237503e-03f, -1.124629867e-03f, 0.0f, 1.980176661e-03f,
+        3.627374303e-03f, 3.278082469e-03f, 0.0f, -5.176637322e-03f,
+        -9.072583169e-03f, -7.891793735e-03f, 0.0f, 1.175045036e-02f,
+        2.018146031e-02f, 1.732375845e-02f, 0.0f, -2.579970658e-02f,
+        -4.515305161e-02f, -4.026095197e-02f, 0.0f, 7.208191603e-02f,
+        1.563492566e-01f, 2.240767032e-01f, 2.499932051e-01f, 2.240767032e-01f,
+        1.563492566e-01f, 7.208191603e-02f, 0.0f, -4.026095197e-02f,
+        -4.515305161e-02f, -2.579970658e-02f, 0.0f, 1.732375845e-02f,
+        2.018146031e-02f, 1.175045036e-02f, 0.0f, -7.891793735e-03f,
+        -9.072583169e-03f, -5.176637322e-03f, 0.0f, 3.278082469e-03f,
+        3.627374303e-03f, 1.980176661e-03f, 0.0f, -1.124629867e-03f,
+        -1.164237503e-03f, -5.884715938e-04f, 0.0f, 2.745267120e-04f,
+        2.495545777e-04f, 1.070903454e-04f, 0.0f, -2.935940392e-05f,
+        -1.553078619e-05f, 0.0f, 0.0f, 0.0f,
+    };
+    if (ratio == 2u) {
+        return taps_2x[i];
+    }
+    if (ratio == 4u) {
+        return taps_4x[i];
+    }
+    return i == 0u ? 1.0f : 0.0f;
+}
+
+} // namespace gain
+
+#endif // GAIN_OVERSAMPLING_FILTER_CUH
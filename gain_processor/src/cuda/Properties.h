@@ -20,7 +20,10 @@ lmcqTgaYdZb3MBszdVtM, \
 FHbFSrlQkldT3gl0bCzY, \
 MARWu9r33xCAGYwfOPDP, \
 IU1Gi6vsluEbesDFt2wT, \
-gJsr8J2Jg46tQmjSsINe
+gJsr8J2Jg46tQmjSsINe, \
+Wq0cRv7TnYe2LbA9uKsF, \
+hP4zXm8GdJ1oVt6rNyQc, \
+Dk3sQa9ZeLw5FyU0bTjM
 // clang-format on
 
 #if !defined(GPU_AUDIO_MAC)
@@ -36,9 +39,46 @@ struct ProcessorParameter {
     uint32_t channel_count;
     uint32_t buffer_capacity;
     uint32_t buffer_length;
+    // gain of all samples after the ramp
     float gain;
+    // the first `ramp_length` samples ramp towards `gain`: sample s gets ramp_start + s * ramp_step, or
+    // exp2(ramp_start + s * ramp_step) if `ramp_in_log2` is set (see GainRamp)
+    float ramp_start;
+    float ramp_step;
+    uint32_t ramp_length;
+    uint32_t ramp_in_log2;
+    // limiter (`process_limited` only, see GainLimiter): the ceiling and the release per sample in log2 of the gain,
+    // and the look-ahead in samples
+    float limiter_ceiling;
+    float limiter_release_step;
+    uint32_t limiter_lookahead;
+    // `process_limited` also writes the sanitize counters to output[1] if set
+    uint32_t limiter_count_sanitized;
+    // set for the first launch after the channel layout changed: tasks with per-channel state start over
+    // (see GainProcessorDevice::begin_channel and GainInputPort::m_state_reset)
+    uint32_t reset_state;
+    // per-channel state of `process_limited` and `process_saturated`: output port `state_port` holds `state_stride`
+    // floats for each channel (see GainTaskSettings::GetStatePort); 0 floats for tasks without state
+    uint32_t state_port;
+    uint32_t state_stride;
+    // pair matrix (`process_pair` only, see GainPair): {left from left, left from right, right from left, right from right},
+    // interpolated from `pair_from` to `pair_to` over the buffer
+    float pair_from[4];
+    float pair_to[4];
+    // saturation (`process_saturated` only, see GainOversampler): GainConfig::Saturation, the oversampling ratio R and the
+    // taps per polyphase branch P. The lowpass itself is a constant of the device code (see OversamplingFilter.cuh)
+    uint32_t saturation;
+    uint32_t oversampling_ratio;
+    uint32_t oversampling_taps_per_phase;
 };
 
+// the limiter's look-ahead is staged in shared memory with each tile
+constexpr uint32_t g_limiter_max_lookahead {256u};
+// the oversampling filter taps are staged in shared memory
+constexpr uint32_t g_oversampling_max_ratio {4u};
+constexpr uint32_t g_oversampling_taps_per_phase {16u};
+constexpr uint32_t g_oversampling_max_taps {g_oversampling_max_ratio * g_oversampling_taps_per_phase};
+
 // per task parameter struct. could be different for each task if the processor
 // had more than one. unused in gain_processor.
 using TaskParameter = void;
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_FIBER_SCHEDULER_H
+#define GAIN_FIBER_SCHEDULER_H
+
+#if defined(WIN32)
+#include <windows.h>
+#else
+// the ucontext functions are deprecated on macOS and only declared for X/Open
+#if defined(__APPLE__) && !defined(_XOPEN_SOURCE)
+#define _XOPEN_SOURCE 600
+#endif
+#include <ucontext.h>
+#endif
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__APPLE__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+#endif
+
+namespace gain {
+namespace emulation {
+
+// Runs the emulated threads of one block as fibers on the calling thread (see LaunchConfig).
+//
+// The block executes in phases separated by its barriers: the scheduler resumes every fiber in turn, and each runs
+// until it reaches the next `synchronize()` (which switches back to the scheduler) or returns. Once all fibers have
+// arrived, the barrier is complete and the next phase starts. So a block needs no OS threads at all, and the blocks
+// of a pool's parallel loop run on its workers without oversubscribing them. Fibers and their stacks are kept and
+// reused by the next block on the same OS thread (see ForThisThread).
+class FiberScheduler {
+public:
+    // the device tasks only keep a few scalars and small arrays on the stack
+    static constexpr size_t StackSize {64u * 1024u};
+
+    FiberScheduler() = default;
+    ~FiberScheduler() {
+#if defined(WIN32)
+        for (auto& fiber : m_fibers) {
+            DeleteFiber(fiber->handle);
+        }
+#endif
+    }
+
+    FiberScheduler(const FiberScheduler&) = delete;
+    FiberScheduler& operator=(const FiberScheduler&) = delete;
+
+    // Calls `fn(t)` for every thread t in [0, thread_count) and returns when all calls returned. Every thread must
+    // reach the same barriers, like on the device; otherwise (and if `fn` throws) the block is abandoned and
+    // std::logic_error (or the exception of `fn`) is thrown. The calls waiting at a barrier of an abandoned block are
+    // unwound, so the destructors of their locals run.
+    template <class Fn>
+    void Run(uint32_t thread_count, Fn&& fn) {
+        if (m_running) {
+            throw std::logic_error("FiberScheduler::Run: a fiber can not run a block itself");
+        }
+        m_context = &fn;
+        m_run = [](void* context, uint32_t thread) { (*static_cast<std::remove_reference_t<Fn>*>(context))(thread); };
+        m_exception = nullptr;
+        Prepare(thread_count);
+        m_running = true;
+
+        uint32_t running = thread_count;
+        while (running > 0u) {
+            // one phase: every fiber that has not returned yet runs up to the next barrier
+            uint32_t arrived = 0u;
+            for (uint32_t t = 0; t < thread_count; ++t) {
+                Fiber& fiber = *m_fibers[t];
+                if (fiber.done) {
+                    continue;
+                }
+                Resume(fiber);
+                if (m_exception) {
+                    const std::exception_ptr exception = m_exception;
+                    Abandon(thread_count);
+                    m_running = false;
+                    std::rethrow_exception(exception);
+                }
+                if (fiber.done) {
+                    --running;
+                }
+                else {
+                    ++arrived;
+                }
+            }
+            if (arrived != 0u && arrived != thread_count) {
+                Abandon(thread_count);
+                m_running = false;
+                throw std::logic_error("FiberScheduler::Run: not all threads of the block reach the barrier");
+            }
+        }
+        m_running = false;
+    }
+
+    // the scheduler of the calling OS thread
+    static FiberScheduler& ForThisThread() {
+        thread_local FiberScheduler scheduler;
+        return scheduler;
+    }
+
+    // called by the running fiber: suspends it until all fibers of the block arrived. Throws Unwind if the block was
+    // abandoned meanwhile
+    void Synchronize() {
+        // a function that swallowed Unwind does not get to wait again
+        if (!m_unwinding) {
+            Suspend(*m_fibers[m_current]);
+        }
+        if (m_unwinding) {
+            throw Unwind {};
+        }
+    }
+
+private:
+    // thrown from the barrier of an abandoned block to unwind the fiber's function; not derived from std::exception,
+    // and caught in Main
+    struct Unwind {};
+
+    struct Fiber {
+        FiberScheduler* scheduler {nullptr};
+        uint32_t thread {0u};
+        bool done {true};
+        // set while the fiber's function is running, i.e., it waits at a barrier between phases
+        bool busy {false};
+#if defined(WIN32)
+        LPVOID handle {nullptr};
+#else
+        ucontext_t context {};
+        std::unique_ptr<uint8_t[]> stack;
+#endif
+    };
+
+    // Every fiber runs this loop: the function of the current block for its thread, then back to the scheduler,
+    // which resumes it for the next block
+    static void Main(Fiber& fiber) {
+        FiberScheduler& scheduler = *fiber.scheduler;
+        for (;;) {
+            fiber.busy = true;
+            try {
+                scheduler.m_run(scheduler.m_context, fiber.thread);
+            }
+            catch (const Unwind&) {
+                // the block was abandoned (see Abandon)
+            }
+            catch (...) {
+                if (!scheduler.m_unwinding) {
+                    scheduler.m_exception = std::current_exception();
+                }
+            }
+            fiber.busy = false;
+            fiber.done = true;
+            scheduler.Suspend(fiber);
+        }
+    }
+
+#if defined(WIN32)
+    static void WINAPI Entry(LPVOID parameter) {
+        Main(*static_cast<Fiber*>(parameter));
+    }
+#else
+    // makecontext passes int arguments only; the pointer is split into two
+    static void Entry(int high, int low) {
+        const uintptr_t address = (static_cast<uintptr_t>(static_cast<uint32_t>(high)) << 16 << 16) | static_cast<uint32_t>(low);
+        Main(*reinterpret_cast<Fiber*>(address));
+    }
+#endif
+
+    // creates the missing fibers and marks the first `thread_count` as ready
+    void Prepare(uint32_t thread_count) {
+#if defined(WIN32)
+        if (m_scheduler == nullptr) {
+            m_scheduler = IsThreadAFiber() ? GetCurrentFiber() : ConvertThreadToFiber(nullptr);
+            if (m_scheduler == nullptr) {
+                throw std::runtime_error("Error in FiberScheduler::Prepare: ConvertThreadToFiber failed");
+            }
+        }
+#endif
+        while (m_fibers.size() < thread_count) {
+            auto fiber = std::make_unique<Fiber>();
+            fiber->scheduler = this;
+            fiber->thread = static_cast<uint32_t>(m_fibers.size());
+            Start(*fiber);
+            m_fibers.push_back(std::move(fiber));
+        }
+        for (uint32_t t = 0; t < thread_count; ++t) {
+            m_fibers[t]->done = false;
+        }
+    }
+
+    // starts the fiber at the top of Main
+    void Start(Fiber& fiber) {
+#if defined(WIN32)
+        fiber.handle = CreateFiber(StackSize, &Entry, &fiber);
+        if (fiber.handle == nullptr) {
+            throw std::runtime_error("Error in FiberScheduler::Start: CreateFiber failed");
+        }
+#else
+        // not value-initialized: only the pages a fiber touches are committed
+        fiber.stack.reset(new uint8_t[StackSize]);
+        if (getcontext(&fiber.context) != 0) {
+            throw std::runtime_error("Error in FiberScheduler::Start: getcontext failed");
+        }
+        fiber.context.uc_stack.ss_sp = fiber.stack.get();
+        fiber.context.uc_stack.ss_size = StackSize;
+        fiber.context.uc_link = nullptr;
+        const uintptr_t address = reinterpret_cast<uintptr_t>(&fiber);
+        makecontext(&fiber.context, reinterpret_cast<void (*)()>(&Entry), 2, static_cast<int>(address >> 16 >> 16),
+            static_cast<int>(address & 0xFFFFFFFFu));
+#endif
+    }
+
+    // Fibers stopped at a barrier in the middle of their function are resumed once more, and their Synchronize
+    // throws Unwind: the stack unwinds to Main, which suspends the fiber at the top of its loop for the next block.
+    // Restarting the fibers instead would skip the destructors of everything on their stacks
+    void Abandon(uint32_t thread_count) {
+        m_unwinding = true;
+        for (uint32_t t = 0; t < thread_count; ++t) {
+            Fiber& fiber = *m_fibers[t];
+            if (fiber.busy) {
+                Resume(fiber);
+            }
+            fiber.done = true;
+        }
+        m_unwinding = false;
+    }
+
+    void Resume(Fiber& fiber) {
+        m_current = fiber.thread;
+#if defined(WIN32)
+        SwitchToFiber(fiber.handle);
+#else
+        swapcontext(&m_scheduler, &fiber.context);
+#endif
+    }
+
+    void Suspend(Fiber& fiber) {
+#if defined(WIN32)
+        static_cast<void>(fiber);
+        SwitchToFiber(m_scheduler);
+#else
+        swapcontext(&fiber.context, &m_scheduler);
+#endif
+    }
+
+    // the fibers never move: a suspended context may point into itself
+    std::vector<std::unique_ptr<Fiber>> m_fibers;
+#if defined(WIN32)
+    LPVOID m_scheduler {nullptr};
+#else
+    ucontext_t m_scheduler {};
+#endif
+    uint32_t m_current {0u};
+    bool m_running {false};
+    // set while Abandon unwinds the fibers
+    bool m_unwinding {false};
+    void* m_context {nullptr};
+    void (*m_run)(void*, uint32_t) {nullptr};
+    std::exception_ptr m_exception;
+};
+
+} // namespace emulation
+} // namespace gain
+
+#if defined(__APPLE__)
+#pragma clang diagnostic pop
+#endif
+
+#endif // GAIN_FIBER_SCHEDULER_H
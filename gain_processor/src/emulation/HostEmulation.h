@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_HOST_EMULATION_H
+#define GAIN_HOST_EMULATION_H
+
+// Host emulation of the device scheduler. It allows to compile the device processor (GainProcessor.cuh)
+// as plain C++ and to run its tasks on the CPU, e.g., for offline rendering or testing without a GPU.
+// Define GAIN_HOST_EMULATION before including GainProcessor.cuh to use it instead of <platform/Abstraction.h>.
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "FiberScheduler.h"
+#include "WorkStealingPool.h"
+
+// device function and address space qualifiers are meaningless on the host
+#ifndef __device_fct
+#define __device_fct
+#endif
+#ifndef __device_addr
+#define __device_addr
+#endif
+
+namespace gain {
+namespace emulation {
+
+// Launch configuration of one task; mirrors the relevant members of GPUA::processor::v2::GpuTaskData
+struct LaunchConfig {
+    uint32_t block_count {1u};
+    uint32_t thread_count {1u};
+    uint32_t shared_mem_size {0u};
+    uint32_t call {0u};
+    // run the threads of a block one after the other on the calling thread, without switching between fibers. Only
+    // valid for tasks that never call `synchronize()` (it throws std::logic_error)
+    bool sequential_threads {false};
+    // runs the blocks in parallel on this pool (e.g., WorkStealingPool::Shared()); nullptr runs them one after the
+    // other on the calling thread. The threads of a block still run as configured above.
+    WorkStealingPool* pool {nullptr};
+};
+
+// Host implementation of the `Context` passed to every device task (see GainProcessorDevice::process)
+class HostContext {
+public:
+    HostContext(uint32_t call, uint32_t block_id, uint32_t thread_id, uint32_t block_dim, void* smem, FiberScheduler* fibers, bool sequential = false) :
+        m_call {call},
+        m_block_id {block_id},
+        m_thread_id {thread_id},
+        m_block_dim {block_dim},
+        m_smem {smem},
+        m_fibers {fibers},
+        m_sequential {sequential} {}
+
+    uint32_t call() const { return m_call; }
+    uint32_t blockId() const { return m_block_id; }
+    uint32_t threadId() const { return m_thread_id; }
+    uint32_t blockDim() const { return m_block_dim; }
+    void* smem() const { return m_smem; }
+
+    void synchronize() const {
+        if (m_sequential) {
+            throw std::logic_error("HostContext::synchronize: the task synchronizes, it can not run with sequential threads");
+        }
+        if (m_fibers) {
+            m_fibers->Synchronize();
+        }
+    }
+
+private:
+    uint32_t m_call;
+    uint32_t m_block_id;
+    uint32_t m_thread_id;
+    uint32_t m_block_dim;
+    void* m_smem;
+    FiberScheduler* m_fibers;
+    bool m_sequential;
+};
+
+// Runs all threads of one block on the calling thread. A single-thread block runs inline, as do all threads with
+// `sequential_threads`; otherwise the emulated threads run as fibers, in phases between the block's barriers.
+template <class Task>
+void LaunchBlock(const LaunchConfig& config, uint32_t block_id, std::vector<uint8_t>& smem, Task& task) {
+    if (config.thread_count <= 1u) {
+        HostContext context {config.call, block_id, 0u, 1u, smem.data(), nullptr};
+        task(context);
+        return;
+    }
+
+    if (config.sequential_threads) {
+        for (uint32_t t = 0; t < config.thread_count; ++t) {
+            HostContext context {config.call, block_id, t, config.thread_count, smem.data(), nullptr, true};
+            task(context);
+        }
+        return;
+    }
+
+    FiberScheduler& fibers = FiberScheduler::ForThisThread();
+    fibers.Run(config.thread_count, [&](uint32_t t) {
+        HostContext context {config.call, block_id, t, config.thread_count, smem.data(), &fibers};
+        task(context);
+    });
+}
+
+// Runs a task over the whole grid, block after block or on the pool of the config. `task` is invoked with a
+// HostContext&; with a pool it is called from several threads at once for different blocks.
+template <class Task>
+void Launch(const LaunchConfig& config, Task&& task) {
+    if (config.pool != nullptr && config.block_count > 1u) {
+        config.pool->ParallelFor(config.block_count, [&](uint32_t b) {
+            // every thread of the pool has its own shared memory, reused for all blocks it runs
+            thread_local std::vector<uint8_t> smem;
+            smem.resize(config.shared_mem_size);
+            LaunchBlock(config, b, smem, task);
+        });
+        return;
+    }
+
+    std::vector<uint8_t> smem(config.shared_mem_size);
+    for (uint32_t b = 0; b < config.block_count; ++b) {
+        LaunchBlock(config, b, smem, task);
+    }
+}
+
+// Owns a device processor object in host memory and calls its mandatory `init` once
+template <class Device>
+class EmulatedDevice {
+public:
+    explicit EmulatedDevice(uint32_t max_buffer_length) {
+        HostContext context {0u, 0u, 0u, 1u, nullptr, nullptr};
+        m_device.init(context, max_buffer_length);
+    }
+
+    Device& operator*() { return m_device; }
+    Device* operator->() { return &m_device; }
+
+private:
+    Device m_device;
+};
+
+} // namespace emulation
+} // namespace gain
+
+#endif // GAIN_HOST_EMULATION_H
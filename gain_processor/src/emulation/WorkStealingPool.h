@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_WORK_STEALING_POOL_H
+#define GAIN_WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace gain {
+namespace emulation {
+
+// Thread pool that runs the blocks of emulated task grids in parallel (see LaunchConfig::pool).
+//
+// A parallel loop starts as one job covering all of its indices. Whoever runs a job splits off its upper half
+// as a new job, until a single index is left, and runs that; so the work is spread in O(log n) steps and every
+// worker first works on its own, contiguous part. Each worker has its own deque: it takes the most recently
+// split-off job from the back, and idle workers steal the largest remaining job from the front of another
+// worker's deque. The thread that starts the loop runs jobs as well until the loop is done, so loops may be
+// started from several threads at once (e.g., by many graph instances sharing one pool) and even from inside a job.
+class WorkStealingPool {
+public:
+    // `worker_count` threads in addition to the threads that start loops; 0 runs every loop on its calling thread
+    explicit WorkStealingPool(uint32_t worker_count) {
+        m_queues.reserve(worker_count + 1u);
+        for (uint32_t w = 0; w <= worker_count; ++w) {
+            m_queues.push_back(std::make_unique<Queue>());
+        }
+        m_workers.reserve(worker_count);
+        for (uint32_t w = 0; w < worker_count; ++w) {
+            m_workers.emplace_back([this, w] { Work(w); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock {m_sleep_mutex};
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // one worker per hardware thread besides the caller, shared by all users in the process
+    static WorkStealingPool& Shared() {
+        static WorkStealingPool pool {std::thread::hardware_concurrency() > 1u ? std::thread::hardware_concurrency() - 1u : 0u};
+        return pool;
+    }
+
+    uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+    // Calls `fn(i)` for every i in [0, count) and returns when all calls are done. The first exception thrown by
+    // `fn` is rethrown after the remaining calls finished.
+    template <class Fn>
+    void ParallelFor(uint32_t count, Fn&& fn) {
+        if (count == 0u) {
+            return;
+        }
+        Loop loop;
+        loop.context = &fn;
+        loop.run = [](void* context, uint32_t index) { (*static_cast<std::remove_reference_t<Fn>*>(context))(index); };
+        loop.remaining.store(count, std::memory_order_relaxed);
+
+        Push({&loop, 0u, count});
+        // help until the loop is done; jobs of other loops are fine as well. Once there has been nothing to take for
+        // a while, the rest of the loop runs on other threads: block until its last call signals the loop, waking up
+        // now and then to help in case another job was queued meanwhile
+        uint32_t idle = 0u;
+        while (loop.remaining.load(std::memory_order_acquire) != 0u) {
+            Job job;
+            if (Take(job)) {
+                Run(job);
+                idle = 0u;
+            }
+            else if (++idle < g_spin_count) {
+                std::this_thread::yield();
+            }
+            else {
+                std::unique_lock<std::mutex> lock {loop.done_mutex};
+                loop.done_signal.wait_for(lock, g_help_interval, [&] { return loop.done; });
+            }
+        }
+        // the last call signals under the mutex; once it is released, nothing touches the loop any more
+        {
+            std::unique_lock<std::mutex> lock {loop.done_mutex};
+            loop.done_signal.wait(lock, [&] { return loop.done; });
+        }
+        if (loop.error) {
+            std::rethrow_exception(loop.error);
+        }
+    }
+
+private:
+    // fruitless attempts to take a job before the thread that started a loop blocks, and how often it wakes up to help
+    static constexpr uint32_t g_spin_count {64u};
+    static constexpr std::chrono::milliseconds g_help_interval {1};
+
+    struct Loop {
+        void* context {nullptr};
+        void (*run)(void*, uint32_t) {nullptr};
+        std::atomic<uint32_t> remaining {0u};
+        std::mutex error_mutex;
+        std::exception_ptr error;
+        // set by the last call of the loop
+        std::mutex done_mutex;
+        std::condition_variable done_signal;
+        bool done {false};
+    };
+
+    struct Job {
+        Loop* loop {nullptr};
+        uint32_t begin {0u};
+        uint32_t end {0u};
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    // index of the calling thread's queue; threads outside of the pool share the last queue
+    uint32_t OwnQueue() const {
+        return t_worker_pool == this ? t_worker_index : static_cast<uint32_t>(m_queues.size() - 1u);
+    }
+
+    void Push(const Job& job) {
+        // counted before it is visible, so the count never drops below the number of queued jobs; sequentially
+        // consistent with the sleeping count, so either this thread sees the sleeper or the sleeper sees the job
+        m_pending.fetch_add(1u);
+        Queue& queue = *m_queues[OwnQueue()];
+        {
+            std::lock_guard<std::mutex> lock {queue.mutex};
+            queue.jobs.push_back(job);
+        }
+        if (m_sleeping.load() > 0u) {
+            std::lock_guard<std::mutex> lock {m_sleep_mutex};
+            m_wake.notify_one();
+        }
+    }
+
+    // the newest job of the own queue, or the oldest (i.e., largest) job of another queue
+    bool Take(Job& job) {
+        if (m_pending.load(std::memory_order_acquire) == 0u) {
+            return false;
+        }
+        const uint32_t own = OwnQueue();
+        {
+            Queue& queue = *m_queues[own];
+            std::lock_guard<std::mutex> lock {queue.mutex};
+            if (!queue.jobs.empty()) {
+                job = queue.jobs.back();
+                queue.jobs.pop_back();
+                m_pending.fetch_sub(1u, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        const uint32_t queue_count = static_cast<uint32_t>(m_queues.size());
+        for (uint32_t i = 1; i < queue_count; ++i) {
+            Queue& victim = *m_queues[(own + i) % queue_count];
+            std::lock_guard<std::mutex> lock {victim.mutex};
+            if (!victim.jobs.empty()) {
+                job = victim.jobs.front();
+                victim.jobs.pop_front();
+                m_pending.fetch_sub(1u, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Run(Job job) {
+        // split off the upper half until one index is left, so idle threads can steal it
+        while (job.end - job.begin > 1u) {
+            const uint32_t middle = job.begin + (job.end - job.begin) / 2u;
+            Push({job.loop, middle, job.end});
+            job.end = middle;
+        }
+        Loop& loop = *job.loop;
+        try {
+            loop.run(loop.context, job.begin);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock {loop.error_mutex};
+            if (!loop.error) {
+                loop.error = std::current_exception();
+            }
+        }
+        // The loop lives on the stack of the thread that started it, which returns once `done` is set; so the last
+        // call signals it under the mutex and touches nothing after
+        if (loop.remaining.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+            std::lock_guard<std::mutex> lock {loop.done_mutex};
+            loop.done = true;
+            loop.done_signal.notify_one();
+        }
+    }
+
+    void Work(uint32_t index) {
+        t_worker_pool = this;
+        t_worker_index = index;
+        while (true) {
+            Job job;
+            if (Take(job)) {
+                Run(job);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock {m_sleep_mutex};
+            m_sleeping.fetch_add(1u);
+            m_wake.wait(lock, [&] { return m_stop || m_pending.load() > 0u; });
+            m_sleeping.fetch_sub(1u);
+            if (m_stop) {
+                return;
+            }
+        }
+    }
+
+    static inline thread_local const WorkStealingPool* t_worker_pool {nullptr};
+    static inline thread_local uint32_t t_worker_index {0u};
+
+    // one queue per worker plus one for all other threads
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_workers;
+    // jobs in all queues
+    std::atomic<uint32_t> m_pending {0u};
+
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wake;
+    std::atomic<uint32_t> m_sleeping {0u};
+    bool m_stop {false};
+};
+
+} // namespace emulation
+} // namespace gain
+
+#endif // GAIN_WORK_STEALING_POOL_H
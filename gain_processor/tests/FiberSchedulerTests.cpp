@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+// Tests of the fibers that run the emulated threads of a block between its barriers (see HostEmulation.h)
+
+#include "HostEmulation.h"
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using gain::emulation::HostContext;
+using gain::emulation::LaunchConfig;
+
+// every thread sees the writes of all others after a barrier, like in shared memory on the device
+TEST(FiberSchedulerTest, BarriersSeparatePhases) {
+    constexpr uint32_t thread_count {256u};
+    LaunchConfig config {};
+    config.block_count = 3u;
+    config.thread_count = thread_count;
+    config.shared_mem_size = thread_count * sizeof(uint32_t);
+
+    std::vector<uint32_t> sums(config.block_count * thread_count);
+    gain::emulation::Launch(config, [&](HostContext& context) {
+        auto values = static_cast<uint32_t*>(context.smem());
+        // a block sum in shared memory, rotated by one thread per phase
+        values[context.threadId()] = context.threadId() + context.blockId();
+        context.synchronize();
+        uint32_t sum = 0u;
+        for (uint32_t t = 0; t < context.blockDim(); ++t) {
+            sum += values[t];
+        }
+        context.synchronize();
+        values[(context.threadId() + 1u) % context.blockDim()] = sum;
+        context.synchronize();
+        sums[context.blockId() * thread_count + context.threadId()] = values[context.threadId()];
+    });
+    for (uint32_t b = 0; b < config.block_count; ++b) {
+        const uint32_t expected = thread_count * (thread_count - 1u) / 2u + b * thread_count;
+        for (uint32_t t = 0; t < thread_count; ++t) {
+            ASSERT_EQ(sums[b * thread_count + t], expected) << "thread " << t << " of block " << b;
+        }
+    }
+}
+
+// a barrier that some threads skip would hang on the device; the emulation throws and can run the next block
+TEST(FiberSchedulerTest, RejectsDivergentBarriersAndRecovers) {
+    LaunchConfig config {};
+    config.thread_count = 64u;
+    EXPECT_THROW(gain::emulation::Launch(config,
+                     [](HostContext& context) {
+                         if (context.threadId() % 2u == 0u) {
+                             context.synchronize();
+                         }
+                     }),
+        std::logic_error);
+    EXPECT_THROW(gain::emulation::Launch(config,
+                     [](HostContext& context) {
+                         context.synchronize();
+                         if (context.threadId() == 7u) {
+                             throw std::runtime_error("thread 7");
+                         }
+                         context.synchronize();
+                     }),
+        std::runtime_error);
+
+    std::vector<uint32_t> threads(config.thread_count, 0u);
+    gain::emulation::Launch(config, [&](HostContext& context) {
+        context.synchronize();
+        ++threads[context.threadId()];
+    });
+    EXPECT_EQ(std::accumulate(threads.begin(), threads.end(), 0u), config.thread_count);
+}
+
+// the threads of a failed block are unwound, so the locals they hold at a barrier are destroyed
+TEST(FiberSchedulerTest, UnwindsAbandonedThreads) {
+    struct Local {
+        explicit Local(int& live) : live {live} { ++live; }
+        ~Local() { --live; }
+        int& live;
+    };
+    LaunchConfig config {};
+    config.thread_count = 64u;
+    int live = 0;
+    EXPECT_THROW(gain::emulation::Launch(config,
+                     [&](HostContext& context) {
+                         Local local {live};
+                         context.synchronize();
+                         if (context.threadId() == 7u) {
+                             throw std::runtime_error("thread 7");
+                         }
+                         context.synchronize();
+                     }),
+        std::runtime_error);
+    EXPECT_EQ(live, 0);
+    EXPECT_THROW(gain::emulation::Launch(config,
+                     [&](HostContext& context) {
+                         Local local {live};
+                         if (context.threadId() % 2u == 0u) {
+                             context.synchronize();
+                         }
+                     }),
+        std::logic_error);
+    EXPECT_EQ(live, 0);
+}
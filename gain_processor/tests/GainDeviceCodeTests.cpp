@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "DeviceCodeIndex.h"
+
+#include <gain_processor/GainDeviceCode.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+// engines may hash device code with their own FNV-1a implementation, so the hash must match the reference vectors
+TEST(GainDeviceCodeTest, HashMatchesFnv1aReference) {
+    static_assert(GainConfig::HashDeviceCode("", 0u) == 0xCBF29CE484222325ull, "FNV-1a offset basis");
+    EXPECT_EQ(GainConfig::HashDeviceCode("a", 1u), 0xAF63DC4C8601EC8Cull);
+    EXPECT_EQ(GainConfig::HashDeviceCode("foobar", 6u), 0x85944171F73967E8ull);
+}
+
+TEST(GainDeviceCodeTest, HashCoversEveryByte) {
+    std::string code(4096u, '\0');
+    const uint64_t hash = GainConfig::HashDeviceCode(code.data(), code.size());
+    code[2048u] = '\x01';
+    EXPECT_NE(GainConfig::HashDeviceCode(code.data(), code.size()), hash);
+    EXPECT_NE(GainConfig::HashDeviceCode(code.data(), code.size() - 1u), hash);
+}
+
+TEST(GainDeviceCodeTest, HashResourceRoundTrips) {
+    char digits[g_device_code_hash_digits];
+    FormatDeviceCodeHash(0x0123456789ABCDEFull, digits);
+    EXPECT_EQ(std::string(digits, sizeof(digits)), "0123456789abcdef");
+    uint64_t hash = 0u;
+    const std::string resource {"85944171f73967e8\n"};
+    ASSERT_TRUE(ParseDeviceCodeHash(resource.data(), resource.data() + resource.size(), hash));
+    EXPECT_EQ(hash, 0x85944171F73967E8ull);
+    const std::string invalid_resources[] {"85944171f73967e", "85944171f73967e80", "85944171f73967eg", std::string(16u, '\0')};
+    for (const std::string& invalid : invalid_resources) {
+        EXPECT_FALSE(ParseDeviceCodeHash(invalid.data(), invalid.data() + invalid.size(), hash)) << invalid;
+    }
+}
+
+namespace {
+
+constexpr const char* g_test_dir_variable {"GAIN_DEVICE_CODE_TEST_DIR"};
+const std::string g_filename {"libgain_processor.test.bin"};
+constexpr char g_embedded_code[] {"\x7f" "ELF embedded"};
+constexpr uint64_t g_embedded_hash {0x0123456789ABCDEFull};
+
+// the hash stands in for the one of the build, so it is not the hash of the code
+DeviceCodeIndex::EmbeddedCode FindTestCode(const std::string& filename) {
+    if (filename != g_filename) {
+        throw std::runtime_error("no embedded code for " + filename);
+    }
+    return {g_embedded_code, sizeof(g_embedded_code), g_embedded_hash};
+}
+
+void SetTestDir(const std::string& dir) {
+#if defined(_WIN32)
+    _putenv_s(g_test_dir_variable, dir.c_str());
+#else
+    setenv(g_test_dir_variable, dir.c_str(), 1);
+#endif
+}
+
+// device code with the platform's header
+std::string DeviceCode(const std::string& body) {
+    return std::string(g_device_code_magic, sizeof(g_device_code_magic)) + body;
+}
+
+std::string Content(const DeviceCodeBlob& blob) {
+    return std::string(blob.data, blob.size);
+}
+
+class DeviceCodeIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_dir = std::filesystem::temp_directory_path() / "gain_device_code_test";
+        std::filesystem::remove_all(m_dir);
+        std::filesystem::create_directories(m_dir);
+        SetTestDir(m_dir.string());
+    }
+
+    void TearDown() override {
+        SetTestDir("");
+        std::filesystem::remove_all(m_dir);
+    }
+
+    // replaces the file atomically, like a build should
+    void Install(const std::string& filename, const std::string& content) {
+        const std::filesystem::path temporary = m_dir / (filename + ".tmp");
+        {
+            std::ofstream file {temporary, std::ios::binary};
+            file << content;
+        }
+        std::filesystem::rename(temporary, m_dir / filename);
+    }
+
+    std::filesystem::path m_dir;
+};
+
+} // namespace
+
+TEST_F(DeviceCodeIndexTest, ServesEmbeddedCodeWithItsBuildHash) {
+    DeviceCodeIndex index {FindTestCode, g_test_dir_variable};
+    const auto blob = index.Find(g_filename);
+    EXPECT_EQ(blob->data, g_embedded_code);
+    EXPECT_EQ(blob->hash, g_embedded_hash);
+    EXPECT_TRUE(blob->path.empty());
+    EXPECT_EQ(index.Find(g_filename), blob);
+    EXPECT_THROW(index.Find("libgain_processor.other.bin"), std::runtime_error);
+}
+
+// only an index with an override variable (GAIN_DEVICE_CODE_OVERRIDE builds) reads the directory
+TEST_F(DeviceCodeIndexTest, OverrideIsGated) {
+    const std::string code = DeviceCode(" override");
+    Install(g_filename, code);
+    DeviceCodeIndex embedded_only {FindTestCode};
+    EXPECT_EQ(embedded_only.Find(g_filename)->data, g_embedded_code);
+
+    DeviceCodeIndex index {FindTestCode, g_test_dir_variable};
+    const auto blob = index.Find(g_filename);
+    EXPECT_EQ(Content(*blob), code);
+    EXPECT_EQ(blob->hash, GainConfig::HashDeviceCode(code.data(), code.size()));
+    EXPECT_EQ(blob->path, (m_dir / g_filename).string());
+
+    SetTestDir("");
+    EXPECT_EQ(index.Find(g_filename)->data, g_embedded_code);
+}
+
+// an unchanged file is served from the index; a replaced one is read again while the old blob stays valid
+TEST_F(DeviceCodeIndexTest, ReusesUnchangedFilesAndPicksUpRebuilds) {
+    DeviceCodeIndex index {FindTestCode, g_test_dir_variable};
+    Install(g_filename, DeviceCode(" first"));
+    const auto first = index.Find(g_filename);
+    EXPECT_EQ(index.Find(g_filename), first);
+
+    Install(g_filename, DeviceCode(" second build"));
+    const auto second = index.Find(g_filename);
+    EXPECT_NE(second, first);
+    EXPECT_EQ(Content(*second), DeviceCode(" second build"));
+    EXPECT_NE(second->hash, first->hash);
+    EXPECT_EQ(Content(*first), DeviceCode(" first"));
+    EXPECT_EQ(index.Find(g_filename), second);
+
+    std::filesystem::remove(m_dir / g_filename);
+    EXPECT_EQ(index.Find(g_filename)->data, g_embedded_code);
+}
+
+TEST_F(DeviceCodeIndexTest, RejectsInvalidAndMismatchedFiles) {
+    DeviceCodeIndex index {FindTestCode, g_test_dir_variable};
+    // no device code header, or a binary of another platform
+    Install(g_filename, "not device code");
+    EXPECT_EQ(index.Find(g_filename)->data, g_embedded_code);
+    std::filesystem::remove(m_dir / g_filename);
+    Install("libgain_processor.other.bin", DeviceCode(" other"));
+    EXPECT_EQ(index.Find(g_filename)->data, g_embedded_code);
+
+    // a broken rebuild keeps the last valid override
+    Install(g_filename, DeviceCode(" valid"));
+    const auto valid = index.Find(g_filename);
+    EXPECT_EQ(Content(*valid), DeviceCode(" valid"));
+    Install(g_filename, std::string(g_device_code_magic, 2u));
+    EXPECT_EQ(index.Find(g_filename), valid);
+    Install(g_filename, DeviceCode(" fixed"));
+    EXPECT_EQ(Content(*index.Find(g_filename)), DeviceCode(" fixed"));
+}
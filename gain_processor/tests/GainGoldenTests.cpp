@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+// Golden-reference tests of the device tasks. The device code runs in the host emulation and must match the scalar
+// references of GainReference.h, bit for bit where a task computes each sample like the reference and within a
+// tolerance where it sums in another order (the limiter's scans and the oversampler's polyphase filters). The time
+// of the tasks relative to their references is measured by `gain_benchmark reference`, not here.
+
+#include "GainProcessor.cuh"
+#include "GainReference.h"
+#include "GainTaskSettings.h"
+#include "LaunchTuning.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+struct Geometry {
+    uint32_t capacity;
+    uint32_t buffer_length;
+};
+
+// the tasks besides `process`, and the ramps of the gain (run by `process`)
+enum class GoldenTask {
+    eSanitized,
+    eLinearRamp,
+    eDecibelRamp,
+    eLimited,
+    ePair,
+    eSaturated
+};
+
+using GoldenCase = std::tuple<uint32_t, Geometry, float>;
+using TaskCase = std::tuple<GoldenTask, uint32_t, Geometry, float>;
+
+// largest difference to the reference of the tasks that sum in another order
+constexpr float g_reordering_tolerance {1e-5f};
+
+// deterministic input in [-2, 2) without special values; beyond +-1, so that the huge gain overflows
+std::vector<float> MakeInput(size_t sample_count) {
+    std::vector<float> input(sample_count);
+    uint32_t state = 0x12345678u;
+    for (auto& sample : input) {
+        state = state * 1664525u + 1013904223u;
+        sample = static_cast<float>(state >> 8) / static_cast<float>(1u << 22) - 2.0f;
+    }
+    return input;
+}
+
+// the input with a NaN, an infinity or a subnormal every few samples
+std::vector<float> MakeSpecialInput(size_t sample_count) {
+    std::vector<float> input = MakeInput(sample_count);
+    for (size_t i = 0; i < sample_count; ++i) {
+        if (i % 37u == 5u) {
+            input[i] = std::numeric_limits<float>::quiet_NaN();
+        }
+        else if (i % 41u == 7u) {
+            input[i] = -std::numeric_limits<float>::infinity();
+        }
+        else if (i % 43u == 11u) {
+            input[i] = std::numeric_limits<float>::denorm_min();
+        }
+    }
+    return input;
+}
+
+std::string GainName(float gain) {
+    if (gain == 0.0f) {
+        return "Zero";
+    }
+    if (gain == 1.0f) {
+        return "Unity";
+    }
+    if (gain == -1.0f) {
+        return "Invert";
+    }
+    if (gain < 0.0f) {
+        return "Negative";
+    }
+    if (gain > 1e30f) {
+        return "Huge";
+    }
+    return gain > 1.0f ? "Boost" : "Other";
+}
+
+std::string TaskName(GoldenTask task) {
+    switch (task) {
+    case GoldenTask::eSanitized:
+        return "Sanitized";
+    case GoldenTask::eLinearRamp:
+        return "LinearRamp";
+    case GoldenTask::eDecibelRamp:
+        return "DecibelRamp";
+    case GoldenTask::eLimited:
+        return "Limited";
+    case GoldenTask::ePair:
+        return "Pair";
+    case GoldenTask::eSaturated:
+        return "Saturated";
+    }
+    return "Unknown";
+}
+
+std::string CaseName(uint32_t channel_count, const Geometry& geometry, float gain) {
+    std::ostringstream name;
+    name << "Channels" << channel_count << "_Capacity" << geometry.capacity << "_Length" << geometry.buffer_length << "_Gain" << GainName(gain);
+    return name.str();
+}
+
+std::string CaseName(const GoldenCase& golden_case) {
+    const auto& [channel_count, geometry, gain] = golden_case;
+    return CaseName(channel_count, geometry, gain);
+}
+
+std::string CaseName(const TaskCase& task_case) {
+    const auto& [task, channel_count, geometry, gain] = task_case;
+    return TaskName(task) + "_" + CaseName(channel_count, geometry, gain);
+}
+
+bool BitEqual(float a, float b) {
+    uint32_t bits_a;
+    uint32_t bits_b;
+    std::memcpy(&bits_a, &a, sizeof(float));
+    std::memcpy(&bits_b, &b, sizeof(float));
+    return bits_a == bits_b;
+}
+
+void ExpectMatches(const std::vector<float>& output, const std::vector<float>& expected, uint32_t capacity, float tolerance) {
+    for (size_t i = 0; i < output.size(); ++i) {
+        const bool match = BitEqual(output[i], expected[i]) || std::abs(output[i] - expected[i]) <= tolerance;
+        ASSERT_TRUE(match) << "sample " << i % capacity << " of channel " << i / capacity << ": " << output[i] << " != " << expected[i];
+    }
+}
+
+class GainGoldenTest : public ::testing::TestWithParam<GoldenCase> {};
+
+class GainTaskGoldenTest : public ::testing::TestWithParam<TaskCase> {};
+
+TEST_P(GainGoldenTest, MatchesReference) {
+    const auto& [channel_count, geometry, gain_value] = GetParam();
+    const size_t sample_count = static_cast<size_t>(channel_count) * geometry.capacity;
+
+    gain::ProcessorParameter params {};
+    params.channel_count = channel_count;
+    params.buffer_capacity = geometry.capacity;
+    params.buffer_length = geometry.buffer_length;
+    params.gain = gain_value;
+
+    std::vector<float> input = MakeInput(sample_count);
+    // samples past the buffer length must not be written; a NaN sentinel is never bit-equal by accident
+    std::vector<float> output(sample_count, std::numeric_limits<float>::quiet_NaN());
+    std::vector<float> expected(output);
+    gain_reference::Gain(params, input.data(), expected.data());
+
+    // the launch geometry of the processor (see GainProcessor::OnBlueprintRebuild); `process` does not
+    // synchronize, so the emulated threads can run sequentially
+    gain::emulation::LaunchConfig config {};
+    config.block_count = channel_count;
+    config.thread_count = gain::SelectThreadCount(gain::g_launch_tuning, channel_count, geometry.capacity);
+    config.sequential_threads = true;
+
+    gain::emulation::EmulatedDevice<GainProcessorDevice<float>> device {geometry.capacity};
+    float* input_ports[] = {input.data()};
+    float* output_ports[] = {output.data()};
+    const auto run_task = [&] {
+        gain::emulation::Launch(config, [&](gain::emulation::HostContext& context) {
+            device->process(context, &params, nullptr, input_ports, output_ports);
+        });
+    };
+    run_task();
+    ExpectMatches(output, expected, geometry.capacity, 0.0f);
+}
+
+INSTANTIATE_TEST_SUITE_P(GeometryMatrix, GainGoldenTest,
+    ::testing::Combine(
+        ::testing::Values(1u, 2u, 8u, 64u, 512u),
+        ::testing::Values(
+            // full buffers of a typical capacity
+            Geometry {256u, 256u},
+            // capacity not a multiple of 32 (the wavefront size)
+            Geometry {1000u, 1000u},
+            // partially filled buffer
+            Geometry {1000u, 333u}),
+        ::testing::Values(0.0f, 1.0f, -1.0f, -0.37f, 3.0e38f)),
+    [](const ::testing::TestParamInfo<GoldenCase>& info) { return CaseName(info.param); });
+
+// The tasks are set up through GainTaskSettings like in the processor, and run once from a reset state.
+TEST_P(GainTaskGoldenTest, MatchesReference) {
+    const auto& [task, channel_count, geometry, gain_value] = GetParam();
+    const size_t sample_count = static_cast<size_t>(channel_count) * geometry.capacity;
+    const bool ramp = task == GoldenTask::eLinearRamp || task == GoldenTask::eDecibelRamp;
+
+    GainConfig::Specification specification {};
+    // the ramps start from a quarter
+    specification.gain_value = ramp ? 0.25f : gain_value;
+    specification.sanitize = task == GoldenTask::eSanitized || task == GoldenTask::eLimited ? 1u : 0u;
+    specification.limit = task == GoldenTask::eLimited ? 1u : 0u;
+    specification.limiter_lookahead = 48u;
+    specification.limiter_release = 480u;
+    specification.pair_mode = task == GoldenTask::ePair ? GainConfig::PairMode::eMidSide : GainConfig::PairMode::eNone;
+    specification.saturation = task == GoldenTask::eSaturated ? GainConfig::Saturation::eSoftClip : GainConfig::Saturation::eNone;
+    specification.oversampling = 4u;
+    GainTaskSettings settings {specification};
+
+    if (ramp) {
+        // reaches the gain a few samples past the middle of the buffer, in dB towards its magnitude
+        GainConfig::Parameters message {};
+        message.gain_value = task == GoldenTask::eLinearRamp ? gain_value : 20.0f * std::log10(std::abs(gain_value));
+        message.unit = task == GoldenTask::eLinearRamp ? GainConfig::GainUnit::eLinear : GainConfig::GainUnit::eDecibel;
+        message.ramp_length = geometry.buffer_length / 2u + 7u;
+        settings.SetGain(message);
+    }
+    if (task == GoldenTask::ePair) {
+        // moves from the identity to a narrower image within the buffer
+        GainConfig::MidSideParameters message {};
+        message.mid_gain = 1.0f;
+        message.side_gain = 0.5f;
+        settings.SetMidSide(message);
+    }
+    gain::ProcessorParameter params {};
+    settings.PrepareChunk(channel_count, geometry.capacity, geometry.buffer_length, true, params);
+
+    const bool special = task == GoldenTask::eSanitized || task == GoldenTask::eLimited;
+    std::vector<float> input = special ? MakeSpecialInput(sample_count) : MakeInput(sample_count);
+    std::vector<float> output(sample_count, std::numeric_limits<float>::quiet_NaN());
+    std::vector<float> expected(output);
+    std::vector<uint32_t> counters(channel_count, 0xFFFFFFFFu);
+    std::vector<uint32_t> expected_counters(counters);
+    std::vector<float> state(static_cast<size_t>(channel_count) * settings.GetStateSize());
+    const auto run_reference = [&] {
+        switch (task) {
+        case GoldenTask::eSanitized:
+            gain_reference::Gain(params, input.data(), expected.data(), expected_counters.data());
+            break;
+        case GoldenTask::eLimited:
+            for (uint32_t c = 0; c < channel_count; ++c) {
+                gain_reference::LimiterState state;
+                const size_t offset = static_cast<size_t>(c) * geometry.capacity;
+                expected_counters[c] = gain_reference::Limit(params, state, input.data() + offset, expected.data() + offset);
+            }
+            break;
+        case GoldenTask::ePair:
+            gain_reference::Pair(params, input.data(), expected.data());
+            break;
+        case GoldenTask::eSaturated:
+            for (uint32_t c = 0; c < channel_count; ++c) {
+                const size_t offset = static_cast<size_t>(c) * geometry.capacity;
+                gain_reference::Saturate(params, input.data() + offset, expected.data() + offset, geometry.buffer_length);
+            }
+            break;
+        default:
+            gain_reference::Gain(params, input.data(), expected.data());
+            break;
+        }
+    };
+    run_reference();
+
+    // the launch geometry of the processor (see GainProcessor::OnBlueprintRebuild); the tasks that do not
+    // synchronize can run their emulated threads sequentially
+    gain::emulation::LaunchConfig config {};
+    config.block_count = settings.GetBlockCount(channel_count);
+    config.thread_count = gain::SelectThreadCount(gain::g_launch_tuning, config.block_count, geometry.capacity);
+    config.shared_mem_size = settings.GetSharedMemorySize(config.thread_count);
+    config.sequential_threads = ramp || task == GoldenTask::ePair;
+
+    gain::emulation::EmulatedDevice<GainProcessorDevice<float>> device {geometry.capacity};
+    float* input_ports[] = {input.data()};
+    float* output_ports[3] = {output.data(), reinterpret_cast<float*>(counters.data())};
+    output_ports[settings.GetStatePort()] = state.data();
+    const auto run_task = [&] {
+        gain::emulation::Launch(config, [&](gain::emulation::HostContext& context) {
+            switch (settings.GetTaskIndex()) {
+            case 1u:
+                device->process_sanitized(context, &params, nullptr, input_ports, output_ports);
+                break;
+            case 2u:
+                device->process_limited(context, &params, nullptr, input_ports, output_ports);
+                break;
+            case 3u:
+                device->process_pair(context, &params, nullptr, input_ports, output_ports);
+                break;
+            case 4u:
+                device->process_saturated(context, &params, nullptr, input_ports, output_ports);
+                break;
+            default:
+                device->process(context, &params, nullptr, input_ports, output_ports);
+                break;
+            }
+        });
+    };
+    run_task();
+
+    const bool reordered = task == GoldenTask::eLimited || task == GoldenTask::eSaturated;
+    ExpectMatches(output, expected, geometry.capacity, reordered ? g_reordering_tolerance : 0.0f);
+    if (HasFatalFailure()) {
+        return;
+    }
+    EXPECT_EQ(counters, expected_counters);
+}
+
+INSTANTIATE_TEST_SUITE_P(TaskMatrix, GainTaskGoldenTest,
+    ::testing::Combine(
+        ::testing::Values(GoldenTask::eSanitized, GoldenTask::eLinearRamp, GoldenTask::eDecibelRamp, GoldenTask::ePair),
+        ::testing::Values(2u, 8u),
+        ::testing::Values(Geometry {256u, 256u}, Geometry {1000u, 333u}),
+        ::testing::Values(1.0f, -0.37f, 3.0e38f)),
+    [](const ::testing::TestParamInfo<TaskCase>& info) { return CaseName(info.param); });
+
+// the limiter and the saturation keep per-channel state in a port sized for any channel count; the saturation's gain
+// is its drive
+INSTANTIATE_TEST_SUITE_P(StatefulTaskMatrix, GainTaskGoldenTest,
+    ::testing::Combine(
+        ::testing::Values(GoldenTask::eLimited, GoldenTask::eSaturated),
+        ::testing::Values(2u, 48u),
+        ::testing::Values(Geometry {256u, 256u}, Geometry {1000u, 333u}),
+        ::testing::Values(1.0f, 4.0f)),
+    [](const ::testing::TestParamInfo<TaskCase>& info) { return CaseName(info.param); });
+
+} // namespace
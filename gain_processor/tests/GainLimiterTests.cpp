@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+// Tests of the look-ahead limiter (process_limited) in the host emulation, set up through GainTaskSettings
+
+#include "GainProcessor.cuh"
+#include "GainTaskSettings.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t g_thread_count {64u};
+
+class LimiterRunner {
+public:
+    LimiterRunner(const GainConfig::Specification& specification, uint32_t channel_count, uint32_t capacity) :
+        m_settings {specification},
+        m_channel_count {channel_count},
+        m_capacity {capacity},
+        m_device {capacity},
+        m_state(static_cast<size_t>(channel_count) * m_settings.GetStateSize()) {
+    }
+
+    // processes `buffer_length` samples of each channel of the planar `input`
+    void Run(std::vector<float>& input, std::vector<float>& output, uint32_t buffer_length) {
+        gain::ProcessorParameter params {};
+        m_settings.PrepareChunk(m_channel_count, m_capacity, buffer_length, m_reset_state, params);
+        m_reset_state = false;
+
+        gain::emulation::LaunchConfig config {};
+        config.block_count = m_settings.GetBlockCount(m_channel_count);
+        config.thread_count = g_thread_count;
+        config.shared_mem_size = m_settings.GetSharedMemorySize(g_thread_count);
+        float* input_ports[] = {input.data()};
+        float* output_ports[] = {output.data(), m_state.data()};
+        gain::emulation::Launch(config, [&](gain::emulation::HostContext& context) {
+            m_device->process_limited(context, &params, nullptr, input_ports, output_ports);
+        });
+    }
+
+private:
+    GainTaskSettings m_settings;
+    uint32_t m_channel_count;
+    uint32_t m_capacity;
+    gain::emulation::EmulatedDevice<GainProcessorDevice<float>> m_device;
+    // the state port (see GainTaskSettings::GetStatePort)
+    std::vector<float> m_state;
+    bool m_reset_state {true};
+};
+
+GainConfig::Specification MakeSpecification(float gain) {
+    GainConfig::Specification specification {};
+    specification.gain_value = gain;
+    specification.limit = 1u;
+    specification.limiter_ceiling = -1.0f;
+    specification.limiter_lookahead = 48u;
+    specification.limiter_release = 480u;
+    return specification;
+}
+
+// noise in [-1, 1) with sparse peaks of up to 4
+std::vector<float> MakeInput(size_t sample_count) {
+    std::vector<float> input(sample_count);
+    uint32_t state = 0x2468ACE1u;
+    for (size_t i = 0; i < sample_count; ++i) {
+        state = state * 1664525u + 1013904223u;
+        const float noise = static_cast<float>(state >> 8) / static_cast<float>(1u << 23) - 1.0f;
+        input[i] = (i % 97u == 13u) ? 4.0f * noise : noise;
+    }
+    return input;
+}
+
+} // namespace
+
+TEST(GainLimiterTest, CeilingIsNeverExceeded) {
+    constexpr uint32_t channel_count {3u};
+    constexpr uint32_t capacity {512u};
+    LimiterRunner runner {MakeSpecification(2.0f), channel_count, capacity};
+    const float ceiling = std::pow(10.0f, -1.0f / 20.0f);
+
+    std::vector<float> output(channel_count * capacity);
+    float loudest = 0.0f;
+    for (uint32_t buffer = 0; buffer < 8u; ++buffer) {
+        std::vector<float> input = MakeInput(channel_count * capacity);
+        // a different buffer each time: rotate the noise
+        std::rotate(input.begin(), input.begin() + buffer * 31u, input.end());
+        runner.Run(input, output, capacity);
+        for (const float sample : output) {
+            ASSERT_LE(std::abs(sample), ceiling * 1.0001f);
+            loudest = std::max(loudest, std::abs(sample));
+        }
+    }
+    // the limiter reduces the peaks, it does not mute
+    EXPECT_GT(loudest, 0.5f * ceiling);
+}
+
+// the delay line and the envelope carry over, so a signal limited in several buffers equals one limited at once
+TEST(GainLimiterTest, StateCarriesAcrossBuffers) {
+    constexpr uint32_t length {1024u};
+    constexpr uint32_t split {256u};
+    const std::vector<float> signal = MakeInput(length);
+
+    LimiterRunner whole {MakeSpecification(2.0f), 1u, length};
+    std::vector<float> input {signal};
+    std::vector<float> expected(length);
+    whole.Run(input, expected, length);
+
+    LimiterRunner pieces {MakeSpecification(2.0f), 1u, split};
+    std::vector<float> actual;
+    for (uint32_t offset = 0; offset < length; offset += split) {
+        std::vector<float> piece(signal.begin() + offset, signal.begin() + offset + split);
+        std::vector<float> output(split);
+        pieces.Run(piece, output, split);
+        actual.insert(actual.end(), output.begin(), output.end());
+    }
+    for (uint32_t s = 0; s < length; ++s) {
+        ASSERT_NEAR(actual[s], expected[s], 1e-6f) << "sample " << s;
+    }
+
+    // the output is the input delayed by the look-ahead, scaled by at most the gain
+    for (uint32_t s = 48u; s < length; ++s) {
+        ASSERT_LE(std::abs(expected[s]), 2.0f * std::abs(signal[s - 48u]) + 1e-6f) << "sample " << s;
+    }
+    for (uint32_t s = 0; s < 48u; ++s) {
+        EXPECT_EQ(expected[s], 0.0f);
+    }
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include <gain_processor/GainMessageStream.h>
+#include <gain_processor/GainSpecification.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+std::vector<GainConfig::MessageStreamReader::Record> ReadAll(const void* data, size_t size) {
+    std::vector<GainConfig::MessageStreamReader::Record> records;
+    const GainConfig::MessageStreamReader reader {data, size};
+    if (reader.Validate()) {
+        reader.ForEach([&](const GainConfig::MessageStreamReader::Record& record) { records.push_back(record); });
+    }
+    return records;
+}
+
+} // namespace
+
+TEST(GainMessageStreamTest, RoundTrip) {
+    alignas(4) uint8_t buffer[256];
+    GainConfig::MessageStreamWriter writer {buffer, sizeof(buffer)};
+
+    GainConfig::Parameters gain {};
+    gain.gain_value = -6.0f;
+    gain.unit = GainConfig::GainUnit::eDecibel;
+    gain.ramp_length = 480u;
+    GainConfig::BalanceParameters balance {};
+    balance.balance = 0.25f;
+    ASSERT_TRUE(writer.Append(gain));
+    ASSERT_TRUE(writer.Append(balance));
+
+    const auto records = ReadAll(writer.GetData(), writer.GetSize());
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0].message, GainConfig::Parameters::GainMessage);
+    EXPECT_EQ(records[0].size, sizeof(GainConfig::Parameters));
+    EXPECT_EQ(records[1].message, GainConfig::BalanceParameters::BalanceMessage);
+
+    // the records point into the buffer; nothing is copied
+    const auto* read_gain = static_cast<const GainConfig::Parameters*>(records[0].payload);
+    EXPECT_GE(static_cast<const void*>(read_gain), static_cast<const void*>(buffer));
+    EXPECT_LT(static_cast<const void*>(read_gain), static_cast<const void*>(buffer + sizeof(buffer)));
+    EXPECT_EQ(read_gain->gain_value, -6.0f);
+    EXPECT_EQ(read_gain->ramp_length, 480u);
+    EXPECT_EQ(static_cast<const GainConfig::BalanceParameters*>(records[1].payload)->balance, 0.25f);
+}
+
+TEST(GainMessageStreamTest, WriterStopsAtCapacity) {
+    alignas(4) uint8_t buffer[sizeof(GainConfig::MessageStream) + sizeof(GainConfig::MessageRecord) + sizeof(GainConfig::Parameters)];
+    GainConfig::MessageStreamWriter writer {buffer, sizeof(buffer)};
+    EXPECT_TRUE(writer.Append(GainConfig::Parameters {}));
+    EXPECT_FALSE(writer.Append(GainConfig::Parameters {}));
+    EXPECT_EQ(ReadAll(writer.GetData(), writer.GetSize()).size(), 1u);
+}
+
+TEST(GainMessageStreamTest, RejectsCorruptStreams) {
+    alignas(4) uint8_t buffer[128];
+    GainConfig::MessageStreamWriter writer {buffer, sizeof(buffer)};
+    ASSERT_TRUE(writer.Append(GainConfig::Parameters {}));
+    const uint32_t size = writer.GetSize();
+    auto* header = reinterpret_cast<GainConfig::MessageStream*>(buffer);
+    auto* record = reinterpret_cast<GainConfig::MessageRecord*>(buffer + sizeof(GainConfig::MessageStream));
+
+    EXPECT_TRUE(GainConfig::MessageStreamReader(buffer, size).Validate());
+    // truncated blob
+    EXPECT_FALSE(GainConfig::MessageStreamReader(buffer, size - 4u).Validate());
+
+    // newer major version
+    header->major_version = GainConfig::MessageStream::MajorVersion + 1u;
+    EXPECT_FALSE(GainConfig::MessageStreamReader(buffer, size).Validate());
+    header->major_version = GainConfig::MessageStream::MajorVersion;
+
+    // record larger than the stream
+    record->size += 4u;
+    EXPECT_FALSE(GainConfig::MessageStreamReader(buffer, size).Validate());
+    record->size -= 4u;
+
+    // record id does not match the payload
+    record->message = GainConfig::MidSideParameters::MidSideMessage;
+    EXPECT_FALSE(GainConfig::MessageStreamReader(buffer, size).Validate());
+    record->message = GainConfig::Parameters::GainMessage;
+
+    // more records announced than present
+    ++header->record_count;
+    EXPECT_FALSE(GainConfig::MessageStreamReader(buffer, size).Validate());
+}
+
+TEST(GainMessageStreamTest, AcceptsNewerMinorVersions) {
+    // a newer minor version appended a member to a message and added a message id the reader does not know
+    struct ExtendedParameters {
+        uint32_t ThisMessage {GainConfig::Parameters::GainMessage};
+        float gain_value {0.5f};
+        GainConfig::GainUnit unit {GainConfig::GainUnit::eLinear};
+        uint32_t ramp_length {};
+        float appended {};
+    };
+    struct FutureMessage {
+        uint32_t ThisMessage {0xDE2F5300};
+        uint32_t value {};
+    };
+    alignas(4) uint8_t buffer[128];
+    GainConfig::MessageStreamWriter writer {buffer, sizeof(buffer)};
+    ASSERT_TRUE(writer.Append(FutureMessage {}));
+    ASSERT_TRUE(writer.Append(ExtendedParameters {}));
+    reinterpret_cast<GainConfig::MessageStream*>(buffer)->minor_version = GainConfig::MessageStream::MinorVersion + 1u;
+
+    const auto records = ReadAll(writer.GetData(), writer.GetSize());
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0].message, 0xDE2F5300u);
+    EXPECT_EQ(records[1].message, GainConfig::Parameters::GainMessage);
+    // the known members are read in place
+    EXPECT_EQ(records[1].size, sizeof(ExtendedParameters));
+    EXPECT_EQ(static_cast<const GainConfig::Parameters*>(records[1].payload)->gain_value, 0.5f);
+}
+
+TEST(GainMessageStreamTest, SingleMessagesAreNoStream) {
+    GainConfig::Parameters gain {};
+    EXPECT_FALSE(GainConfig::MessageStreamReader(&gain, sizeof(gain)).IsStream());
+    EXPECT_FALSE(GainConfig::MessageStreamReader(nullptr, 0u).IsStream());
+}
+
+// the first versions of the gain message and the specification had only a linear gain
+TEST(GainMessageStreamTest, ReadsEveryVersionOfTheSpecification) {
+    const uint32_t v1[] = {GainConfig::Specification::GainConstructionType, GainConfig::Parameters::GainMessage, 0x3F000000u};
+    static_assert(sizeof(v1) == GainConfig::g_specification_v1_size, "the first specification has three members");
+    GainConfig::Specification specification;
+    ASSERT_TRUE(GainConfig::ReadVersioned(v1, sizeof(v1), GainConfig::g_specification_v1_size, specification));
+    EXPECT_EQ(specification.gain_value, 0.5f);
+    EXPECT_EQ(specification.gain_unit, GainConfig::GainUnit::eLinear);
+    EXPECT_EQ(specification.sanitize, 0u);
+    EXPECT_EQ(specification.oversampling, 1u);
+    EXPECT_FALSE(GainConfig::ReadVersioned(v1, sizeof(v1) - 1u, GainConfig::g_specification_v1_size, specification));
+
+    // a newer specification with members appended after the ones known here
+    std::vector<uint8_t> newer(sizeof(GainConfig::Specification) + 16u, 0xFFu);
+    GainConfig::Specification current;
+    current.limit = 1u;
+    std::memcpy(newer.data(), &current, sizeof(current));
+    ASSERT_TRUE(GainConfig::ReadVersioned(newer.data(), newer.size(), GainConfig::g_specification_v1_size, specification));
+    EXPECT_EQ(specification.limit, 1u);
+    EXPECT_EQ(specification.oversampling, current.oversampling);
+
+    const uint32_t gain_v1[] = {GainConfig::Parameters::GainMessage, 0x40000000u};
+    GainConfig::Parameters params;
+    ASSERT_TRUE(GainConfig::ReadVersioned(gain_v1, sizeof(gain_v1), GainConfig::g_parameters_v1_size, params));
+    EXPECT_EQ(params.gain_value, 2.0f);
+    EXPECT_EQ(params.unit, GainConfig::GainUnit::eLinear);
+    EXPECT_EQ(params.ramp_length, 0u);
+}
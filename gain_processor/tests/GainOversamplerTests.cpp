@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+// Tests of the oversampled saturation (process_saturated) in the host emulation: the polyphase filters of the device
+// against the direct form of GainReference.h
+
+#include "GainOversampler.h"
+#include "GainProcessor.cuh"
+#include "GainReference.h"
+#include "GainTaskSettings.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t g_capacity {300u};
+constexpr uint32_t g_thread_count {64u};
+// buffer lengths of the consecutive launches: full, partial, shorter and longer than the block, a single sample
+constexpr uint32_t g_buffer_lengths[] {300u, 77u, 256u, 1u, 150u};
+
+GainConfig::Specification MakeSpecification(uint32_t ratio, GainConfig::Saturation saturation, float drive) {
+    GainConfig::Specification specification {};
+    specification.gain_value = drive;
+    specification.saturation = saturation;
+    specification.oversampling = ratio;
+    return specification;
+}
+
+// two sines that reach +-1.3 together
+std::vector<float> MakeInput(size_t sample_count) {
+    std::vector<float> input(sample_count);
+    for (size_t i = 0; i < sample_count; ++i) {
+        const float t = static_cast<float>(i);
+        input[i] = 0.8f * std::sin(0.031f * t) + 0.5f * std::sin(0.47f * t + 1.0f);
+    }
+    return input;
+}
+
+// runs process_saturated over one channel of `signal`, in launches of g_buffer_lengths, and returns the output
+std::vector<float> RunSaturated(const GainConfig::Specification& specification, const std::vector<float>& signal, gain::ProcessorParameter& params) {
+    GainTaskSettings settings {specification};
+    gain::emulation::EmulatedDevice<GainProcessorDevice<float>> device {g_capacity};
+    gain::emulation::LaunchConfig config {};
+    config.block_count = 1u;
+    config.thread_count = g_thread_count;
+    config.shared_mem_size = settings.GetSharedMemorySize(g_thread_count);
+    std::vector<float> state(settings.GetStateSize());
+
+    std::vector<float> output;
+    size_t offset = 0u;
+    for (size_t launch = 0; offset < signal.size(); ++launch) {
+        const uint32_t length = static_cast<uint32_t>(std::min<size_t>(g_buffer_lengths[launch % std::size(g_buffer_lengths)], signal.size() - offset));
+        std::vector<float> input(g_capacity, 0.0f);
+        std::copy(signal.begin() + offset, signal.begin() + offset + length, input.begin());
+        std::vector<float> buffer(g_capacity);
+        settings.PrepareChunk(1u, g_capacity, length, launch == 0u, params);
+
+        float* input_ports[] = {input.data()};
+        float* output_ports[] = {buffer.data(), state.data()};
+        gain::emulation::Launch(config, [&](gain::emulation::HostContext& context) {
+            device->process_saturated(context, &params, nullptr, input_ports, output_ports);
+        });
+        output.insert(output.end(), buffer.begin(), buffer.begin() + length);
+        offset += length;
+    }
+    return output;
+}
+
+} // namespace
+
+// the polyphase interpolator and decimator, tiled over blocks and carried across launches, equal the direct form
+TEST(GainOversamplerTest, PolyphaseMatchesDirectForm) {
+    const std::vector<float> signal = MakeInput(2000u);
+    for (const uint32_t ratio : {1u, 2u, 4u}) {
+        for (const auto saturation : {GainConfig::Saturation::eHardClip, GainConfig::Saturation::eSoftClip}) {
+            SCOPED_TRACE(testing::Message() << "ratio " << ratio << ", saturation " << static_cast<uint32_t>(saturation));
+            gain::ProcessorParameter params {};
+            const std::vector<float> actual = RunSaturated(MakeSpecification(ratio, saturation, 1.5f), signal, params);
+
+            std::vector<float> expected(signal.size());
+            gain_reference::Saturate(params, signal.data(), expected.data(), static_cast<uint32_t>(signal.size()));
+            for (size_t s = 0; s < signal.size(); ++s) {
+                ASSERT_NEAR(actual[s], expected[s], 1e-5f) << "sample " << s;
+            }
+        }
+    }
+}
+
+// below the clipping level the saturation is linear: a slow sine comes out delayed by the filters' latency
+TEST(GainOversamplerTest, DelaysByTheLatency) {
+    std::vector<float> signal(1000u);
+    for (size_t s = 0; s < signal.size(); ++s) {
+        signal[s] = std::sin(0.031f * static_cast<float>(s));
+    }
+    for (const uint32_t ratio : {2u, 4u}) {
+        SCOPED_TRACE(testing::Message() << "ratio " << ratio);
+        const GainConfig::Specification specification = MakeSpecification(ratio, GainConfig::Saturation::eHardClip, 0.5f);
+        const uint32_t latency = GainOversampler {specification}.GetLatency();
+        EXPECT_EQ(latency, gain::g_oversampling_taps_per_phase - 1u);
+
+        gain::ProcessorParameter params {};
+        const std::vector<float> output = RunSaturated(specification, signal, params);
+        // a sample off would be off by up to 0.5 * 0.031
+        for (size_t s = 2u * latency; s < signal.size(); ++s) {
+            ASSERT_NEAR(output[s], 0.5f * signal[s - latency], 1e-3f) << "sample " << s;
+        }
+    }
+}
+
+// the constant filter table is linear phase (symmetric around its center tap) with unity gain at DC, and the
+// padding after its R * (P - 1) + 1 taps is zero
+TEST(GainOversamplerTest, FilterTableIsLinearPhase) {
+    for (const uint32_t ratio : {1u, 2u, 4u}) {
+        SCOPED_TRACE(testing::Message() << "ratio " << ratio);
+        const uint32_t phase_taps = ratio > 1u ? gain::g_oversampling_taps_per_phase : 1u;
+        const uint32_t length = ratio * (phase_taps - 1u) + 1u;
+        double sum = 0.0;
+        for (uint32_t i = 0; i < length; ++i) {
+            EXPECT_EQ(gain::OversamplingTap(ratio, i), gain::OversamplingTap(ratio, length - 1u - i)) << "tap " << i;
+            sum += gain::OversamplingTap(ratio, i);
+        }
+        EXPECT_NEAR(sum, 1.0, 1e-6);
+        for (uint32_t i = length; i < ratio * phase_taps; ++i) {
+            EXPECT_EQ(gain::OversamplingTap(ratio, i), 0.0f) << "tap " << i;
+        }
+    }
+}
+
+// relative to the Nyquist frequency of the input, the lowpass attenuates images and aliases by at least 80 dB from
+// 1.36 on and keeps the band up to 0.73 within 0.1 dB (see OversamplingFilter.cuh)
+TEST(GainOversamplerTest, FilterRejectsStopband) {
+    constexpr double pi {3.14159265358979323846};
+    constexpr uint32_t points {2000u};
+    for (const uint32_t ratio : {2u, 4u}) {
+        SCOPED_TRACE(testing::Message() << "ratio " << ratio);
+        const uint32_t taps = ratio * gain::g_oversampling_taps_per_phase;
+        double stopband {-300.0};
+        double passband {0.0};
+        // up to the Nyquist frequency of the oversampled rate, which is `ratio` times the one of the input
+        for (uint32_t k = 0; k <= points; ++k) {
+            const double frequency = static_cast<double>(ratio) * k / points;
+            double re {0.0};
+            double im {0.0};
+            for (uint32_t i = 0; i < taps; ++i) {
+                const double phase = pi * frequency / ratio * i;
+                re += gain::OversamplingTap(ratio, i) * std::cos(phase);
+                im -= gain::OversamplingTap(ratio, i) * std::sin(phase);
+            }
+            const double db = 10.0 * std::log10(std::max(re * re + im * im, 1e-30));
+            if (frequency >= 1.36) {
+                stopband = std::max(stopband, db);
+            }
+            if (frequency <= 0.73) {
+                passband = std::max(passband, std::abs(db));
+            }
+        }
+        EXPECT_LE(stopband, -80.0);
+        EXPECT_LE(passband, 0.1);
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+// Tests of the channel pair matrices (GainPair) and of process_pair in the host emulation
+
+#include "GainPair.h"
+#include "GainProcessor.cuh"
+#include "GainTaskSettings.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+constexpr GainPair::Matrix g_identity {1.0f, 0.0f, 0.0f, 1.0f};
+
+float ToDecibel(float gain) {
+    return 20.0f * std::log10(gain);
+}
+
+} // namespace
+
+TEST(GainPairTest, UnityMidSideIsTheIdentity) {
+    EXPECT_EQ(GainPair::MidSideMatrix(1.0f, 1.0f), g_identity);
+    // no side: both channels get the mid signal
+    EXPECT_EQ(GainPair::MidSideMatrix(1.0f, 0.0f), (GainPair::Matrix {0.5f, 0.5f, 0.5f, 0.5f}));
+
+    GainConfig::Specification specification {};
+    specification.gain_value = 1.0f;
+    specification.pair_mode = GainConfig::PairMode::eMidSide;
+    GainTaskSettings settings {specification};
+    GainConfig::MidSideParameters message {};
+    ASSERT_TRUE(settings.SetMidSide(message));
+
+    constexpr uint32_t channel_count {4u};
+    constexpr uint32_t capacity {96u};
+    gain::ProcessorParameter params {};
+    settings.PrepareChunk(channel_count, capacity, capacity, true, params);
+
+    std::vector<float> input(channel_count * capacity);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = std::sin(0.37f * static_cast<float>(i)) * static_cast<float>(1u + i % 3u);
+    }
+    std::vector<float> output(input.size());
+    gain::emulation::LaunchConfig config {};
+    config.block_count = settings.GetBlockCount(channel_count);
+    config.thread_count = 32u;
+    gain::emulation::EmulatedDevice<GainProcessorDevice<float>> device {capacity};
+    float* input_ports[] = {input.data()};
+    float* output_ports[] = {output.data()};
+    gain::emulation::Launch(config, [&](gain::emulation::HostContext& context) {
+        device->process_pair(context, &params, nullptr, input_ports, output_ports);
+    });
+    EXPECT_EQ(output, input);
+}
+
+TEST(GainPairTest, PanLawCenters) {
+    const GainPair::Matrix balance = GainPair::BalanceMatrix(0.0f, GainConfig::PanLaw::eBalance);
+    EXPECT_EQ(balance, g_identity);
+
+    const GainPair::Matrix power = GainPair::BalanceMatrix(0.0f, GainConfig::PanLaw::eConstantPower);
+    EXPECT_FLOAT_EQ(power[0], power[3]);
+    EXPECT_NEAR(ToDecibel(power[0]), -3.0f, 0.02f);
+    // sin^2 + cos^2: the power of uncorrelated channels is kept
+    EXPECT_NEAR(power[0] * power[0] + power[3] * power[3], 1.0f, 1e-6f);
+
+    const GainPair::Matrix compromise = GainPair::BalanceMatrix(0.0f, GainConfig::PanLaw::eCompromise);
+    EXPECT_FLOAT_EQ(compromise[0], compromise[3]);
+    EXPECT_NEAR(ToDecibel(compromise[0]), -4.5f, 0.02f);
+
+    for (const auto law : {GainConfig::PanLaw::eBalance, GainConfig::PanLaw::eConstantPower, GainConfig::PanLaw::eCompromise}) {
+        // no cross-feed, and hard left mutes the right channel
+        const GainPair::Matrix left = GainPair::BalanceMatrix(-1.0f, law);
+        EXPECT_EQ(left[1], 0.0f);
+        EXPECT_EQ(left[2], 0.0f);
+        EXPECT_NEAR(left[0], 1.0f, 1e-6f);
+        EXPECT_NEAR(left[3], 0.0f, 1e-6f);
+    }
+}
+
+// a new matrix is reached within one buffer and then held
+TEST(GainPairTest, InterpolatesOverOneBuffer) {
+    GainPair pair;
+    pair.SetMidSide(1.0f, 0.5f);
+    gain::ProcessorParameter params {};
+    pair.Next(params);
+    for (uint32_t i = 0; i < 4u; ++i) {
+        EXPECT_EQ(params.pair_from[i], g_identity[i]);
+        EXPECT_EQ(params.pair_to[i], pair.GetTarget()[i]);
+    }
+    pair.Next(params);
+    for (uint32_t i = 0; i < 4u; ++i) {
+        EXPECT_EQ(params.pair_from[i], pair.GetTarget()[i]);
+    }
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#ifndef GAIN_GAIN_REFERENCE_H
+#define GAIN_GAIN_REFERENCE_H
+
+// Scalar references of the device tasks (see GainProcessor.cuh), written for clarity: one sample at a time, in the
+// order of the signal, without tiles, shared memory or parallel scans. Buffers are planar like the ports, with
+// `buffer_capacity` samples per channel.
+
+#include "HostEmulation.h"
+#include "OversamplingFilter.cuh"
+#include "Properties.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace gain_reference {
+
+inline bool NeedsSanitizing(float x) {
+    return !std::isfinite(x) || (x != 0.0f && std::abs(x) < FLT_MIN);
+}
+
+// gain of sample `s`, following the ramp of the processor parameter
+inline float GainAt(const gain::ProcessorParameter& params, uint32_t s) {
+    if (s >= params.ramp_length) {
+        return params.gain;
+    }
+    const float value = params.ramp_start + static_cast<float>(s) * params.ramp_step;
+    return params.ramp_in_log2 ? std::exp2(value) : value;
+}
+
+// `process` and, with `counters`, `process_sanitized`: one counter per channel of the samples that were flushed
+inline void Gain(const gain::ProcessorParameter& params, const float* input, float* output, uint32_t* counters = nullptr) {
+    for (uint32_t c = 0; c < params.channel_count; ++c) {
+        const size_t offset = static_cast<size_t>(c) * params.buffer_capacity;
+        uint32_t count = 0u;
+        for (uint32_t s = 0; s < params.buffer_length; ++s) {
+            float sample = input[offset + s];
+            if (counters == nullptr) {
+                output[offset + s] = sample * GainAt(params, s);
+                continue;
+            }
+            const bool bad_input = NeedsSanitizing(sample);
+            sample = (bad_input ? 0.0f : sample) * GainAt(params, s);
+            const bool bad_output = NeedsSanitizing(sample);
+            output[offset + s] = bad_output ? 0.0f : sample;
+            count += bad_input || bad_output ? 1u : 0u;
+        }
+        if (counters != nullptr) {
+            counters[c] = count;
+        }
+    }
+}
+
+// `process_pair`: the matrix moves linearly from `pair_from` to `pair_to`, reaching it at the last sample
+inline void Pair(const gain::ProcessorParameter& params, const float* input, float* output) {
+    for (uint32_t pair = 0; 2u * pair + 1u < params.channel_count; ++pair) {
+        const size_t left = static_cast<size_t>(2u * pair) * params.buffer_capacity;
+        const size_t right = left + params.buffer_capacity;
+        for (uint32_t s = 0; s < params.buffer_length; ++s) {
+            const float position = static_cast<float>(s + 1u) * (1.0f / static_cast<float>(params.buffer_length));
+            float m[4];
+            for (uint32_t i = 0; i < 4u; ++i) {
+                m[i] = params.pair_from[i] + (params.pair_to[i] - params.pair_from[i]) * position;
+            }
+            const float gain = GainAt(params, s);
+            output[left + s] = (m[0] * input[left + s] + m[1] * input[right + s]) * gain;
+            output[right + s] = (m[2] * input[left + s] + m[3] * input[right + s]) * gain;
+        }
+    }
+}
+
+// `process_limited` of one channel. The state is the delay line and the gain envelope (log2) of the last
+// `limiter_lookahead` samples; empty vectors start from silence. Returns the number of flushed input samples.
+struct LimiterState {
+    std::vector<float> delay;
+    std::vector<float> envelope;
+};
+
+inline uint32_t Limit(const gain::ProcessorParameter& params, LimiterState& state, const float* input, float* output) {
+    const uint32_t lookahead = params.limiter_lookahead;
+    const uint32_t length = params.buffer_length;
+    state.delay.resize(lookahead, 0.0f);
+    state.envelope.resize(lookahead, 0.0f);
+
+    // the delayed input stream: the delay line followed by the gained, sanitized input
+    uint32_t sanitized = 0u;
+    std::vector<float> stream {state.delay};
+    for (uint32_t s = 0; s < length; ++s) {
+        float sample = input[s];
+        const bool bad_input = NeedsSanitizing(sample);
+        sample = (bad_input ? 0.0f : sample) * GainAt(params, s);
+        const bool bad_output = NeedsSanitizing(sample);
+        stream.push_back(bad_output ? 0.0f : sample);
+        sanitized += bad_input || bad_output ? 1u : 0u;
+    }
+
+    // the envelope of the previous samples followed by the one of this buffer
+    std::vector<float> envelope {state.envelope};
+    float previous = lookahead > 0u ? state.envelope.back() : 0.0f;
+    for (uint32_t j = 0; j < length; ++j) {
+        // the gain reduction the loudest sample of the look-ahead needs, released from the previous sample's
+        float peak = 0.0f;
+        for (uint32_t k = 0; k <= lookahead; ++k) {
+            peak = std::max(peak, std::abs(stream[j + k]));
+        }
+        const float needed = peak > 0.0f ? std::min(params.limiter_ceiling - std::log2(peak), 0.0f) : 0.0f;
+        previous = std::min(std::min(needed, previous + params.limiter_release_step), 0.0f);
+        envelope.push_back(previous);
+
+        // the envelope averaged over the look-ahead
+        float sum = 0.0f;
+        for (uint32_t k = 0; k <= lookahead; ++k) {
+            sum += envelope[j + k];
+        }
+        const float sample = stream[j] * std::exp2(sum / static_cast<float>(lookahead + 1u));
+        output[j] = NeedsSanitizing(sample) ? 0.0f : sample;
+    }
+
+    state.delay.assign(stream.end() - lookahead, stream.end());
+    state.envelope.assign(envelope.end() - lookahead, envelope.end());
+    return sanitized;
+}
+
+// the nonlinearity of `process_saturated` (GainConfig::Saturation)
+inline float Saturate(uint32_t saturation, float x) {
+    if (saturation == 1u) {
+        return std::min(std::max(x, -1.0f), 1.0f);
+    }
+    if (saturation == 2u) {
+        const float clamped = std::min(std::max(x, -1.5f), 1.5f);
+        return clamped - (4.0f / 27.0f) * clamped * clamped * clamped;
+    }
+    return x;
+}
+
+// `process_saturated` of a whole signal of `length` samples, from silence, in direct form at the oversampled rate:
+// zero-stuff by R (scaled by R), lowpass, saturate, lowpass and keep every R-th sample
+inline void Saturate(const gain::ProcessorParameter& params, const float* input, float* output, uint32_t length) {
+    const uint32_t ratio = params.oversampling_ratio;
+    const uint32_t taps = ratio * params.oversampling_taps_per_phase;
+    std::vector<float> stuffed(static_cast<size_t>(length) * ratio, 0.0f);
+    for (uint32_t s = 0; s < length; ++s) {
+        stuffed[static_cast<size_t>(s) * ratio] = input[s] * GainAt(params, s) * static_cast<float>(ratio);
+    }
+    std::vector<float> saturated(stuffed.size());
+    for (size_t m = 0; m < stuffed.size(); ++m) {
+        float sum = 0.0f;
+        for (uint32_t j = 0; j < taps && j <= m; ++j) {
+            sum += gain::OversamplingTap(ratio, j) * stuffed[m - j];
+        }
+        saturated[m] = Saturate(params.saturation, sum);
+    }
+    for (uint32_t s = 0; s < length; ++s) {
+        const size_t m = static_cast<size_t>(s) * ratio;
+        float sum = 0.0f;
+        for (uint32_t j = 0; j < taps && j <= m; ++j) {
+            sum += gain::OversamplingTap(ratio, j) * saturated[m - j];
+        }
+        output[s] = sum;
+    }
+}
+
+} // namespace gain_reference
+
+#endif // GAIN_GAIN_REFERENCE_H
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+// Tests of the sanitizing task (process_sanitized) in the host emulation and of the host-side gain sanitizing
+
+#include "GainProcessor.cuh"
+#include "GainTaskSettings.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t g_capacity {64u};
+constexpr uint32_t g_thread_count {32u};
+
+// runs process_sanitized over one channel and returns the channel's counter
+uint32_t RunSanitized(gain::ProcessorParameter& params, std::vector<float>& input, std::vector<float>& output) {
+    gain::emulation::LaunchConfig config {};
+    config.block_count = 1u;
+    config.thread_count = g_thread_count;
+    config.shared_mem_size = g_thread_count * static_cast<uint32_t>(sizeof(uint32_t));
+
+    uint32_t counter = 0u;
+    gain::emulation::EmulatedDevice<GainProcessorDevice<float>> device {g_capacity};
+    float* input_ports[] = {input.data()};
+    float* output_ports[] = {output.data(), reinterpret_cast<float*>(&counter)};
+    gain::emulation::Launch(config, [&](gain::emulation::HostContext& context) {
+        device->process_sanitized(context, &params, nullptr, input_ports, output_ports);
+    });
+    return counter;
+}
+
+gain::ProcessorParameter MakeParameter(float gain) {
+    gain::ProcessorParameter params {};
+    params.channel_count = 1u;
+    params.buffer_capacity = g_capacity;
+    params.buffer_length = g_capacity;
+    params.gain = gain;
+    return params;
+}
+
+} // namespace
+
+TEST(GainSanitizeTest, FlushesAndCountsSpecialValues) {
+    std::vector<float> input(g_capacity, 0.5f);
+    input[0] = std::numeric_limits<float>::quiet_NaN();
+    input[1] = -std::numeric_limits<float>::infinity();
+    input[2] = std::numeric_limits<float>::denorm_min();
+    // valid input that the gain turns into a subnormal
+    input[3] = 1e-10f;
+    std::vector<float> output(g_capacity);
+
+    gain::ProcessorParameter params = MakeParameter(1e-30f);
+    EXPECT_EQ(RunSanitized(params, input, output), 4u);
+    for (uint32_t s = 0; s < 4u; ++s) {
+        EXPECT_EQ(output[s], 0.0f) << "sample " << s;
+    }
+    EXPECT_EQ(output[4], 0.5f * 1e-30f);
+}
+
+// a sample whose input and product are both flushed counts once
+TEST(GainSanitizeTest, CountsEachSampleOnce) {
+    std::vector<float> input(g_capacity, 0.25f);
+    input[0] = std::numeric_limits<float>::quiet_NaN();
+    input[1] = std::numeric_limits<float>::denorm_min();
+    std::vector<float> output(g_capacity);
+
+    // every product is NaN or Inf
+    gain::ProcessorParameter params = MakeParameter(std::numeric_limits<float>::infinity());
+    EXPECT_EQ(RunSanitized(params, input, output), g_capacity);
+    for (const float sample : output) {
+        EXPECT_EQ(sample, 0.0f);
+    }
+}
+
+TEST(GainSanitizeTest, NonFiniteGainIsSilencedOnTheHost) {
+    GainConfig::Specification specification {};
+    specification.sanitize = 1u;
+    GainTaskSettings settings {specification};
+
+    GainConfig::Parameters message {};
+    message.gain_value = std::numeric_limits<float>::quiet_NaN();
+    settings.SetGain(message);
+    gain::ProcessorParameter params {};
+    settings.PrepareChunk(1u, g_capacity, g_capacity, false, params);
+    EXPECT_EQ(params.gain, 0.0f);
+    EXPECT_EQ(params.ramp_length, 0u);
+
+    // without sanitizing, the gain is applied as it is
+    specification.sanitize = 0u;
+    GainTaskSettings unsanitized {specification};
+    unsanitized.SetGain(message);
+    unsanitized.PrepareChunk(1u, g_capacity, g_capacity, false, params);
+    EXPECT_NE(params.gain, params.gain);
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+// Tests of the decibel and fader lookup tables (GainTaper) and of the host-side gain ramp (GainRamp)
+
+#include "GainRamp.h"
+#include "GainTaper.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// 0.001 dB, the accuracy GainTaper promises for its interpolated tables
+constexpr double g_max_error_decibel {0.001};
+
+double ToDecibel(double gain) {
+    return 20.0 * std::log10(gain);
+}
+
+} // namespace
+
+TEST(GainTaperTest, DecibelTableMatchesExactConversion) {
+    const GainTaper& taper = GainTaper::Get(GainConfig::FaderTaper::eAudio);
+    for (float decibel = -119.0f; decibel <= GainTaper::MaxDecibel; decibel += 0.37f) {
+        const float gain = taper.DecibelToLinear(decibel);
+        ASSERT_GT(gain, 0.0f) << decibel << " dB";
+        EXPECT_NEAR(ToDecibel(gain), decibel, g_max_error_decibel) << decibel << " dB";
+    }
+    EXPECT_FLOAT_EQ(taper.ToLinear(GainConfig::GainUnit::eDecibel, 0.0f), 1.0f);
+    EXPECT_NEAR(taper.ToLinear(GainConfig::GainUnit::eDecibel, -6.0f), 0.501187f, 1e-5f);
+    // the bottom of the range and NaN mute, the top clamps
+    EXPECT_EQ(taper.DecibelToLinear(GainTaper::MinDecibel), 0.0f);
+    EXPECT_EQ(taper.DecibelToLinear(-1000.0f), 0.0f);
+    EXPECT_EQ(taper.DecibelToLinear(std::numeric_limits<float>::quiet_NaN()), 0.0f);
+    EXPECT_EQ(taper.DecibelToLinear(100.0f), taper.DecibelToLinear(GainTaper::MaxDecibel));
+    // linear values pass through
+    EXPECT_EQ(taper.ToLinear(GainConfig::GainUnit::eLinear, -0.25f), -0.25f);
+}
+
+TEST(GainTaperTest, FaderTables) {
+    const GainTaper& linear = GainTaper::Get(GainConfig::FaderTaper::eLinear);
+    EXPECT_NEAR(linear.FaderToLinear(0.3f), 0.3f, 1e-6f);
+    EXPECT_EQ(linear.FaderToLinear(-1.0f), 0.0f);
+    EXPECT_EQ(linear.FaderToLinear(2.0f), 1.0f);
+
+    // -60 dB to +6 dB, linear in dB
+    const GainTaper& logarithmic = GainTaper::Get(GainConfig::FaderTaper::eLogarithmic);
+    EXPECT_EQ(logarithmic.FaderToLinear(0.0f), 0.0f);
+    EXPECT_NEAR(ToDecibel(logarithmic.FaderToLinear(0.5f)), -27.0, 0.01);
+    EXPECT_NEAR(ToDecibel(logarithmic.FaderToLinear(1.0f)), 6.0, 0.01);
+
+    // unity at 3/4 of the travel, +10 dB at the top, silence at the bottom
+    const GainTaper& audio = GainTaper::Get(GainConfig::FaderTaper::eAudio);
+    EXPECT_NEAR(audio.FaderToLinear(0.75f), 1.0f, 1e-4f);
+    EXPECT_NEAR(ToDecibel(audio.FaderToLinear(1.0f)), 10.0, 0.01);
+    EXPECT_NEAR(ToDecibel(audio.FaderToLinear(0.5f)), -12.0, 0.01);
+    EXPECT_EQ(audio.FaderToLinear(0.0f), 0.0f);
+    EXPECT_EQ(audio.ToLinear(GainConfig::GainUnit::eFader, std::numeric_limits<float>::quiet_NaN()), 0.0f);
+    // every taper rises monotonically over the travel
+    for (const auto taper : {GainConfig::FaderTaper::eLinear, GainConfig::FaderTaper::eLogarithmic, GainConfig::FaderTaper::eAudio}) {
+        float previous = 0.0f;
+        for (float position = 0.0f; position <= 1.0f; position += 1.0f / 512.0f) {
+            const float gain = GainTaper::Get(taper).FaderToLinear(position);
+            ASSERT_GE(gain, previous) << "taper " << static_cast<uint32_t>(taper) << " at " << position;
+            previous = gain;
+        }
+    }
+}
+
+TEST(GainRampTest, LinearRampSpansBuffers) {
+    GainRamp ramp {0.0f};
+    ramp.SetTarget(1.0f, 100u, false);
+    gain::ProcessorParameter params {};
+
+    ramp.Next(64u, params);
+    EXPECT_EQ(params.gain, 1.0f);
+    EXPECT_EQ(params.ramp_length, 64u);
+    EXPECT_EQ(params.ramp_in_log2, 0u);
+    EXPECT_FLOAT_EQ(params.ramp_start, 0.0f);
+    EXPECT_FLOAT_EQ(params.ramp_step, 0.01f);
+    EXPECT_FLOAT_EQ(ramp.GetCurrent(), 0.64f);
+
+    // the second buffer continues where the first ended and the ramp ends within it
+    ramp.Next(64u, params);
+    EXPECT_EQ(params.ramp_length, 36u);
+    EXPECT_FLOAT_EQ(params.ramp_start, 0.64f);
+
+    ramp.Next(64u, params);
+    EXPECT_EQ(params.ramp_length, 0u);
+    EXPECT_EQ(params.gain, 1.0f);
+    EXPECT_EQ(ramp.GetCurrent(), 1.0f);
+}
+
+// decibel and fader changes ramp linearly in log2 of the gain, i.e., evenly in dB
+TEST(GainRampTest, DecibelRampInterpolatesLog2) {
+    GainRamp ramp {0.25f};
+    ramp.SetTarget(4.0f, 4u, true);
+    gain::ProcessorParameter params {};
+    ramp.Next(2u, params);
+    EXPECT_EQ(params.ramp_in_log2, 1u);
+    EXPECT_FLOAT_EQ(params.ramp_start, -2.0f);
+    EXPECT_FLOAT_EQ(params.ramp_step, 1.0f);
+    // half way in dB between -12 dB and +12 dB is unity
+    EXPECT_FLOAT_EQ(ramp.GetCurrent(), 1.0f);
+
+    // ramps from silence start at -120 dB
+    GainRamp from_silence {0.0f};
+    from_silence.SetTarget(1.0f, 10u, true);
+    from_silence.Next(10u, params);
+    EXPECT_EQ(params.ramp_in_log2, 1u);
+    EXPECT_NEAR(params.ramp_start * 6.0206f, -120.0f, 0.01f);
+
+    // negative gains can not be interpolated in log2 and ramp linearly
+    GainRamp negative {-1.0f};
+    negative.SetTarget(1.0f, 10u, true);
+    negative.Next(10u, params);
+    EXPECT_EQ(params.ramp_in_log2, 0u);
+
+    // no ramp to the current gain
+    GainRamp unchanged {0.5f};
+    unchanged.SetTarget(0.5f, 100u, true);
+    unchanged.Next(10u, params);
+    EXPECT_EQ(params.ramp_length, 0u);
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "ArchList.h"
+#include "LaunchTuning.h"
+
+#include <gtest/gtest.h>
+
+// the list is split at every colon, like the platform names GainModuleInfoProvider reports
+TEST(LaunchTuningTest, ArchListSplitsAtEveryColon) {
+    constexpr std::string_view list {"gfx906:gfx90a:xnack-:gfx1030"};
+    static_assert(gain::ArchCount(list) == 4u, "one entry per colon separated segment");
+    EXPECT_EQ(gain::ArchAt(list, 0u), "gfx906");
+    EXPECT_EQ(gain::ArchAt(list, 1u), "gfx90a");
+    EXPECT_EQ(gain::ArchAt(list, 2u), "xnack-");
+    EXPECT_EQ(gain::ArchAt(list, 3u), "gfx1030");
+    EXPECT_EQ(gain::ArchCount("75:86"), 2u);
+    EXPECT_EQ(gain::ArchAt("75:86", 1u), "86");
+}
+
+TEST(LaunchTuningTest, Wave64Architectures) {
+    EXPECT_TRUE(gain::IsWave64Arch("gfx906"));
+    EXPECT_TRUE(gain::IsWave64Arch("gfx90a"));
+    EXPECT_TRUE(gain::IsWave64Arch("gfx803"));
+    EXPECT_FALSE(gain::IsWave64Arch("gfx1030"));
+    EXPECT_FALSE(gain::IsWave64Arch("gfx1100"));
+    EXPECT_FALSE(gain::IsWave64Arch("xnack-"));
+    EXPECT_TRUE(gain::HasWave64Arch("gfx1030:gfx90a:xnack-"));
+    EXPECT_FALSE(gain::HasWave64Arch("gfx1030:gfx1100"));
+}
+
+TEST(LaunchTuningTest, ThreadCountCoversTheBufferInWavefronts) {
+    const gain::LaunchTuning& tuning = gain::GetLaunchTuning(gain::LaunchPlatform::eAmdWave64);
+    EXPECT_EQ(gain::SelectThreadCount(tuning, 1u, 1u), 64u);
+    EXPECT_EQ(gain::SelectThreadCount(tuning, 1u, 100u), 128u);
+    EXPECT_EQ(gain::SelectThreadCount(tuning, 1u, 4096u), tuning.max_block_size);
+    EXPECT_EQ(gain::SelectThreadCount(tuning, tuning.saturating_block_count, 4096u), tuning.preferred_block_size);
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+// Tests of the WAV header handling and the file mapping of the offline renderer (gain_offline)
+
+#include "AudioFile.h"
+#include "MappedFile.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+std::vector<uint8_t> MakeWav(const AudioFileLayout& layout) {
+    AudioFileLayout header_layout {layout};
+    header_layout.data_offset = GetWavHeaderSize(layout.frame_count, layout.channel_count);
+    std::vector<uint8_t> wav(header_layout.data_offset + layout.frame_count * layout.channel_count * sizeof(float));
+    WriteWavHeader(wav.data(), header_layout);
+    return wav;
+}
+
+} // namespace
+
+TEST(AudioFileTest, WavHeaderRoundTrip) {
+    AudioFileLayout layout {};
+    layout.frame_count = 1000u;
+    layout.channel_count = 6u;
+    layout.sample_rate = 96000u;
+    const std::vector<uint8_t> wav = MakeWav(layout);
+
+    ASSERT_TRUE(IsWav(wav.data(), wav.size()));
+    EXPECT_EQ(std::memcmp(wav.data(), "RIFF", 4), 0);
+    const AudioFileLayout parsed = ParseWavLayout(wav.data(), wav.size());
+    EXPECT_EQ(parsed.data_offset, 44u);
+    EXPECT_EQ(parsed.frame_count, layout.frame_count);
+    EXPECT_EQ(parsed.channel_count, layout.channel_count);
+    EXPECT_EQ(parsed.sample_rate, layout.sample_rate);
+}
+
+// a RIFF size over 4 GB can not be stored in 32 bits; such files are written as RF64 with a ds64 chunk
+TEST(AudioFileTest, LargeFilesUseRf64) {
+    AudioFileLayout layout {};
+    layout.channel_count = 64u;
+    layout.sample_rate = 48000u;
+    layout.frame_count = (uint64_t {1} << 32) / (layout.channel_count * sizeof(float));
+    ASSERT_GT(GetWavHeaderSize(layout.frame_count, layout.channel_count), GetWavHeaderSize(layout.frame_count - 1u, layout.channel_count));
+
+    // only the header is written and parsed, so the samples need not exist
+    layout.data_offset = GetWavHeaderSize(layout.frame_count, layout.channel_count);
+    std::vector<uint8_t> header(layout.data_offset);
+    WriteWavHeader(header.data(), layout);
+    EXPECT_EQ(std::memcmp(header.data(), "RF64", 4), 0);
+    EXPECT_EQ(std::memcmp(header.data() + 12, "ds64", 4), 0);
+
+    const uint64_t file_size = layout.data_offset + layout.frame_count * layout.channel_count * sizeof(float);
+    const AudioFileLayout parsed = ParseWavLayout(header.data(), file_size);
+    EXPECT_EQ(parsed.data_offset, layout.data_offset);
+    EXPECT_EQ(parsed.frame_count, layout.frame_count);
+    EXPECT_EQ(parsed.channel_count, layout.channel_count);
+}
+
+TEST(AudioFileTest, RejectsUnsupportedFiles) {
+    AudioFileLayout layout {};
+    layout.frame_count = 16u;
+    layout.channel_count = 2u;
+    layout.sample_rate = 44100u;
+    std::vector<uint8_t> wav = MakeWav(layout);
+
+    // 16-bit PCM
+    std::vector<uint8_t> pcm {wav};
+    pcm[20] = 1u;
+    pcm[34] = 16u;
+    EXPECT_THROW(ParseWavLayout(pcm.data(), pcm.size()), std::runtime_error);
+    // no data chunk
+    EXPECT_THROW(ParseWavLayout(wav.data(), 36u), std::runtime_error);
+    // no RIFF header
+    EXPECT_FALSE(IsWav(wav.data() + 4, wav.size() - 4u));
+    EXPECT_THROW(MakeRawLayout(1024u, 0u, 48000u), std::runtime_error);
+    EXPECT_EQ(MakeRawLayout(1028u, 2u, 48000u).frame_count, 128u);
+}
+
+TEST(MappedFileTest, WritesAndReadsBack) {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "gain_mapped_file_test.raw";
+    constexpr uint64_t size {3u * 4096u + 5u};
+    {
+        MappedFile file {path, MappedFile::Mode::eReadWrite, size};
+        ASSERT_EQ(file.size(), size);
+        for (uint64_t i = 0; i < size; ++i) {
+            file.data()[i] = static_cast<uint8_t>(i * 7u);
+        }
+        file.Release(0u, 4096u);
+    }
+    {
+        const MappedFile file {path, MappedFile::Mode::eReadOnly};
+        ASSERT_EQ(file.size(), size);
+        file.Prefetch(0u, size);
+        bool equal = true;
+        for (uint64_t i = 0; i < size; ++i) {
+            equal = equal && file.data()[i] == static_cast<uint8_t>(i * 7u);
+        }
+        EXPECT_TRUE(equal);
+    }
+    std::filesystem::remove(path);
+    EXPECT_THROW(MappedFile(path, MappedFile::Mode::eReadOnly), std::runtime_error);
+}
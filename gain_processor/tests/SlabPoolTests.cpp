@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "SlabPool.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <vector>
+
+namespace {
+
+struct Object {
+    double values[5];
+};
+
+using Pool = SlabPool<Object, 4u>;
+
+} // namespace
+
+TEST(SlabPoolTest, ReusesFreedSlots) {
+    Pool pool;
+    void* first = pool.Allocate();
+    void* second = pool.Allocate();
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_NE(first, second);
+
+    // the slot freed last is handed out first
+    EXPECT_TRUE(pool.Deallocate(first));
+    EXPECT_EQ(pool.Allocate(), first);
+
+    // slots of a full slab are reused before another slab is added
+    std::set<void*> slots {first, second};
+    for (uint32_t i = 0; i < 2u; ++i) {
+        slots.insert(pool.Allocate());
+    }
+    EXPECT_EQ(slots.size(), 4u);
+    EXPECT_EQ(pool.GetStats().slab_count, 1u);
+    for (void* slot : slots) {
+        EXPECT_TRUE(pool.Deallocate(slot));
+    }
+    for (uint32_t i = 0; i < 4u; ++i) {
+        EXPECT_EQ(slots.count(pool.Allocate()), 1u);
+    }
+    EXPECT_EQ(pool.GetStats().slab_count, 1u);
+}
+
+TEST(SlabPoolTest, OwnsOnlyLiveSlots) {
+    Pool pool;
+    void* slot = pool.Allocate();
+    EXPECT_TRUE(pool.Owns(slot));
+
+    // foreign and misaligned addresses
+    Object object {};
+    EXPECT_FALSE(pool.Owns(&object));
+    EXPECT_FALSE(pool.Owns(static_cast<char*>(slot) + 1));
+    EXPECT_FALSE(pool.Deallocate(&object));
+
+    // a freed slot is no longer owned and can not be freed again
+    EXPECT_TRUE(pool.Deallocate(slot));
+    EXPECT_FALSE(pool.Owns(slot));
+    EXPECT_FALSE(pool.Deallocate(slot));
+    EXPECT_EQ(pool.GetStats().in_use, 0u);
+
+    // the free list is intact: the slot is handed out once
+    EXPECT_EQ(pool.Allocate(), slot);
+    EXPECT_NE(pool.Allocate(), slot);
+}
+
+TEST(SlabPoolTest, Stats) {
+    Pool pool;
+    std::vector<void*> slots;
+    for (uint32_t i = 0; i < 6u; ++i) {
+        slots.push_back(pool.Allocate());
+    }
+    Pool::Stats stats = pool.GetStats();
+    EXPECT_EQ(stats.slab_count, 2u);
+    EXPECT_EQ(stats.capacity, 8u);
+    EXPECT_EQ(stats.in_use, 6u);
+    EXPECT_EQ(stats.peak_in_use, 6u);
+    EXPECT_EQ(stats.allocation_count, 6u);
+
+    for (uint32_t i = 0; i < 3u; ++i) {
+        pool.Deallocate(slots[i]);
+    }
+    pool.Allocate();
+    stats = pool.GetStats();
+    EXPECT_EQ(stats.slab_count, 2u);
+    EXPECT_EQ(stats.in_use, 4u);
+    EXPECT_EQ(stats.peak_in_use, 6u);
+    EXPECT_EQ(stats.allocation_count, 7u);
+}
+
+// slots are found in any of many slabs, and a slot is destroyed once
+TEST(SlabPoolTest, DestroysLiveSlotsOnce) {
+    Pool pool;
+    std::vector<void*> slots;
+    for (uint32_t i = 0; i < 64u; ++i) {
+        slots.push_back(pool.Allocate());
+    }
+    ASSERT_EQ(pool.GetStats().slab_count, 16u);
+    for (void* slot : slots) {
+        EXPECT_TRUE(pool.Owns(slot));
+        EXPECT_FALSE(pool.Owns(static_cast<char*>(slot) + sizeof(double)));
+    }
+
+    uint32_t destroyed = 0u;
+    const auto destroy = [&](Object*) { ++destroyed; };
+    for (void* slot : slots) {
+        EXPECT_TRUE(pool.Destroy(slot, destroy));
+        EXPECT_FALSE(pool.Destroy(slot, destroy));
+        EXPECT_FALSE(pool.Owns(slot));
+    }
+    EXPECT_EQ(destroyed, slots.size());
+    EXPECT_EQ(pool.GetStats().in_use, 0u);
+    Object object {};
+    EXPECT_FALSE(pool.Destroy(&object, destroy));
+    EXPECT_EQ(destroyed, slots.size());
+}
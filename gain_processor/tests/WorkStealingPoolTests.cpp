@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+#include "GainProcessor.cuh"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(WorkStealingPoolTest, RunsEveryIndexOnce) {
+    gain::emulation::WorkStealingPool pool {3u};
+    for (uint32_t count : {1u, 2u, 7u, 1000u}) {
+        std::vector<std::atomic<uint32_t>> calls(count);
+        pool.ParallelFor(count, [&](uint32_t i) { calls[i].fetch_add(1u); });
+        for (uint32_t i = 0; i < count; ++i) {
+            EXPECT_EQ(calls[i].load(), 1u) << "index " << i << " of " << count;
+        }
+    }
+}
+
+TEST(WorkStealingPoolTest, RethrowsAfterAllCallsFinished) {
+    gain::emulation::WorkStealingPool pool {2u};
+    std::atomic<uint32_t> calls {0u};
+    EXPECT_THROW(pool.ParallelFor(64u,
+                     [&](uint32_t i) {
+                         calls.fetch_add(1u);
+                         if (i == 5u) {
+                             throw std::runtime_error {"block failed"};
+                         }
+                     }),
+        std::runtime_error);
+    EXPECT_EQ(calls.load(), 64u);
+}
+
+// several graph instances launching on one pool at once, one of them from inside a job
+TEST(WorkStealingPoolTest, ConcurrentAndNestedLoops) {
+    gain::emulation::WorkStealingPool pool {2u};
+    std::atomic<uint32_t> calls {0u};
+    std::vector<std::thread> launchers;
+    for (uint32_t l = 0; l < 4u; ++l) {
+        launchers.emplace_back([&] {
+            for (uint32_t r = 0; r < 50u; ++r) {
+                pool.ParallelFor(16u, [&](uint32_t i) {
+                    if (i == 0u) {
+                        pool.ParallelFor(4u, [&](uint32_t) { calls.fetch_add(1u); });
+                    }
+                    calls.fetch_add(1u);
+                });
+            }
+        });
+    }
+    for (auto& launcher : launchers) {
+        launcher.join();
+    }
+    EXPECT_EQ(calls.load(), 4u * 50u * (16u + 4u));
+}
+
+// the gain task on the pool writes exactly what the serial launch writes
+TEST(WorkStealingPoolTest, PooledLaunchMatchesSerial) {
+    constexpr uint32_t channel_count {64u};
+    constexpr uint32_t capacity {1000u};
+    std::vector<float> input(channel_count * capacity);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<float>(i % 97u) / 48.0f - 1.0f;
+    }
+    std::vector<float> serial(input.size(), 0.0f);
+    std::vector<float> pooled(input.size(), 0.0f);
+
+    gain::ProcessorParameter params {};
+    params.channel_count = channel_count;
+    params.buffer_capacity = capacity;
+    params.buffer_length = capacity;
+    params.gain = -0.37f;
+
+    gain::emulation::EmulatedDevice<GainProcessorDevice<float>> device {capacity};
+    gain::emulation::LaunchConfig config {};
+    config.block_count = channel_count;
+    config.thread_count = 32u;
+    config.sequential_threads = true;
+    const auto run = [&](std::vector<float>& output) {
+        float* input_ports[] = {input.data()};
+        float* output_ports[] = {output.data()};
+        gain::emulation::Launch(config, [&](gain::emulation::HostContext& context) {
+            device->process(context, &params, nullptr, input_ports, output_ports);
+        });
+    };
+    run(serial);
+    gain::emulation::WorkStealingPool pool {3u};
+    config.pool = &pool;
+    run(pooled);
+    EXPECT_EQ(serial, pooled);
+}
+
+// the launching thread blocks once the rest of its loop runs elsewhere and wakes up when the last call is done
+TEST(WorkStealingPoolTest, WakesBlockedCaller) {
+    gain::emulation::WorkStealingPool pool {2u};
+    std::atomic<uint32_t> calls {0u};
+    for (uint32_t r = 0; r < 20u; ++r) {
+        pool.ParallelFor(2u, [&](uint32_t) {
+            std::this_thread::sleep_for(std::chrono::milliseconds {5});
+            calls.fetch_add(1u);
+        });
+    }
+    EXPECT_EQ(calls.load(), 40u);
+}
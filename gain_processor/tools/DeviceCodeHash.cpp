@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024 Braingines SA - All Rights Reserved
+ * Unauthorized copying of this file is strictly prohibited
+ * Proprietary and confidential
+ */
+
+// Build step that writes the hash resource of an embedded device code binary (see cmake/DeviceCodeHash.cmake):
+//
+//     gain_processor_device_code_hash libgain_processor.sm_86.cubin libgain_processor.sm_86.cubin.fnv1a
+
+#include "DeviceCodeIndex.h"
+
+#include <gain_processor/GainDeviceCode.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <device code> <hash file>" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::ifstream input {argv[1], std::ios::binary};
+    const std::vector<char> code {std::istreambuf_iterator<char> {input}, std::istreambuf_iterator<char> {}};
+    if (!input) {
+        std::cerr << "can not read " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    char digits[g_device_code_hash_digits];
+    FormatDeviceCodeHash(GainConfig::HashDeviceCode(code.data(), code.size()), digits);
+    std::ofstream output {argv[2], std::ios::binary | std::ios::trunc};
+    output.write(digits, sizeof(digits)) << '\n';
+    if (!output.flush()) {
+        std::cerr << "can not write " << argv[2] << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}